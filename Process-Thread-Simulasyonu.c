@@ -3,17 +3,27 @@
 #include <stdlib.h>        // Dinamik bellek yönetimi ve çıkış fonksiyonları için
 #include <unistd.h>        // POSIX sistem çağrıları (fork, getpid vb.) için
 #include <sys/wait.h>      // Süreç bekleme fonksiyonları için
+#include <signal.h>        // Hata enjeksiyonu (raise) için
+#include <sys/stat.h>      // Kontrol noktası dosyasının boyutu (fstat) için
 #include <pthread.h>       // Thread işlemleri için
 #include <semaphore.h>     // Semaforlar için
 #include <time.h>          // Zamanla ilgili fonksiyonlar (rand, nanosleep) için
 #include <fcntl.h>         // Dosya kontrol işlemleri için (paylaşılan bellek)
 #include <sys/mman.h>      // Bellek yönetimi (mmap) için
 #include <string.h>        // strcmp gibi string işlemleri için
+#include <getopt.h>        // Komut satırı seçeneklerini ayrıştırmak için
+#include <stdatomic.h>     // Kilitsiz atomik işlemler için
+#include <stdint.h>        // Sabit genişlikli tamsayı türleri için
+#include <sched.h>         // sched_yield için
+#include <sys/syscall.h>   // Thread kimliği (SYS_gettid) ve futex için
+#include <linux/futex.h>   // Süreçler arası kat bildirimi (FUTEX_WAIT/FUTEX_WAKE) için
+#include <limits.h>        // INT_MAX için
 
-// Apartman yapılandırması için sabitler
-#define TOTAL_FLOORS 10           // Toplam kat sayısı
-#define APARTMENTS_PER_FLOOR 4    // Her katta bulunan daire sayısı
-#define TOTAL_DAYS 365            // Simülasyonun toplam gün sayısı
+// Apartman yapılandırması için varsayılan değerler (--floors, --apartments, --days ya da --config ile değiştirilir)
+#define DEFAULT_FLOORS 10               // Varsayılan kat sayısı
+#define DEFAULT_APARTMENTS_PER_FLOOR 4  // Varsayılan kattaki daire sayısı
+#define DEFAULT_TOTAL_DAYS 365          // Varsayılan planlanan gün sayısı
+#define MAX_UNITS (1L << 22)            // En fazla daire sayısı (daire başına bellek için bkz. unit_memory_bytes)
 
 // Renkli konsol çıktıları için ANSI renk kodları
 #define COLOR_RED     "\033[1;31m"  // Kırmızı renk
@@ -24,46 +34,443 @@
 #define COLOR_CYAN    "\033[1;36m"  // Cyan renk
 #define COLOR_RESET   "\033[0m"     // Renk sıfırlama
 
-// Paylaşılan bellekte maliyetleri saklamak için struct yapısı
+// Maliyet kategorileri
+enum CostCategory {
+    CAT_FOUNDATION,   // Temel atma
+    CAT_FLOOR,        // Kat inşaatı
+    CAT_ELECTRICAL,   // Elektrik tesisatı
+    CAT_PLUMBING,     // Sıhhi tesisat
+    CAT_PAINTING,     // Boya
+    CAT_FLOORING,     // Zemin kaplama
+    CAT_WINDOW,       // Pencere montajı
+    CAT_KITCHEN,      // Mutfak dolabı
+    CAT_BATHROOM,     // Banyo montajı
+    CAT_CLEANING,     // Son temizlik
+    CAT_ROOF,         // Çatı ve ortak alanlar
+    CAT_CREW,         // Ekiplerin şantiyede kaldığı günlerin ücreti
+    CAT_COUNT         // Kategori sayısı
+};
+
+// Kategorilerin kısa adları (maliyet satırlarında) ve özet tablosundaki etiketleri
+static const char *category_names[CAT_COUNT] = {
+    "foundation", "floor", "electrical", "plumbing", "painting", "flooring",
+    "window", "kitchen", "bathroom", "cleaning", "roof", "crew"
+};
+static const char *category_labels[CAT_COUNT] = { // Tablo hizası için boşlukla doldurulmuş
+    "Temel Atma            ", "Kat İnşaatı           ", "Elektrik Tesisatı     ", "Sıhhi Tesisat         ",
+    "Boya                  ", "Zemin Kaplama         ", "Pencere Montajı       ", "Mutfak Dolabı         ",
+    "Banyo Montajı         ", "Son Temizlik          ", "Çatı ve Ortak Alanlar ", "Ekip Günlükleri       "
+};
+
+#define COST_SHARDS 64            // Paylaşılan bellekteki maliyet dilimi sayısı
+#define CACHE_LINE 64             // Önbellek satırı boyutu (bayt)
+#define MAX_PRICE_ITEMS 32        // Fiyat tablosundaki kalem sayısı sınırı (tüm iş türlerinin adımları)
+
+// Bir thread'e ya da sürece ait maliyet dilimi. Her dilime aynı anda tek yazar yazar;
+// dilimler önbellek satırına hizalandığı için yazarlar birbirinin satırını geçersiz kılmaz.
+// Tutarlar kuruş cinsinden tamsayıdır: toplama sırası ve thread sayısı sonucu değiştirmez.
+struct CostShard {
+    _Atomic int64_t material[CAT_COUNT]; // Kategori başına malzeme maliyeti (kuruş)
+    _Atomic int64_t labor[CAT_COUNT];    // Kategori başına işçilik maliyeti (kuruş)
+    _Atomic double quantity[MAX_PRICE_ITEMS]; // Fiyat kalemi başına tüketilen miktar (yeniden fiyatlama için)
+} __attribute__((aligned(CACHE_LINE)));
+
+// Dilimlerin okuma anında toplanmış hali (TL; defterden okunduğunda kuruşu kuruşuna tam)
+struct CostTotals {
+    double material[CAT_COUNT];  // Kategori başına toplam malzeme maliyeti
+    double labor[CAT_COUNT];     // Kategori başına toplam işçilik maliyeti
+    double total;                // Genel toplam
+};
+
+// Kuruş cinsinden tutarı en yakın tam kuruşa yuvarlar (yarım kuruş sıfırdan uzağa)
+static inline int64_t kurus_round(double kurus) {
+    return (int64_t)(kurus + (kurus < 0.0 ? -0.5 : 0.5));
+}
+
+// TL tutarını en yakın kuruşa yuvarlar
+static inline int64_t to_kurus(double tl) {
+    return kurus_round(tl * 100.0);
+}
+
+// Günlük (log) kayıt türleri; kayıtlar ikili olarak tutulur, metne yalnızca boşaltıcı thread çevirir
+enum LogType {
+    LOG_STEP_START,   // Adım başladı (iş türü, adım indeksi, kat, daire)
+    LOG_STEP_DONE,    // Adım bitti
+    LOG_JOB_START,    // İş başlığı (temel, kat, daire, çatı)
+    LOG_JOB_DONE,     // İş bitiş başlığı
+    LOG_COST,         // Maliyet eklendi (kategori, malzeme, işçilik)
+    LOG_DAY,          // Gün bilgisi (gün, toplam maliyet)
+    LOG_MSG           // Sabit metinli mesaj (mesaj kimliği ve iki tamsayı argüman)
+};
+
+// Günlük seviyeleri: seçilen seviyenin üstündeki kayıtlar halkaya hiç yazılmaz
+enum LogLevel {
+    LOG_LEVEL_QUIET,  // Yalnızca sonuç özeti
+    LOG_LEVEL_PHASE,  // Aşama ve gün başlıkları
+    LOG_LEVEL_TASK    // Her adım ve maliyet satırı (varsayılan)
+};
+
+#define LOG_RING_SIZE 8192        // Halkadaki kayıt sayısı (2'nin kuvveti olmalı)
+
+// Sabit boyutlu günlük kaydı; her hücre kendi sıra numarasıyla yazar/okuyucu arasında el değiştirir
+struct LogRecord {
+    _Atomic uint64_t seq;  // Hücre sıra numarası (Vyukov sınırlı kuyruk algoritması)
+    uint8_t type;          // enum LogType
+    uint8_t kind;          // İş türü ya da mesaj kimliği
+    uint8_t index;         // Adım indeksi ya da maliyet kategorisi
+    int32_t pid;           // Kaydı yazan süreç
+    int32_t floor;         // Kat (ya da mesajın ilk argümanı)
+    int32_t apartment;     // Daire (ya da mesajın ikinci argümanı)
+    double time;           // Sanal zaman (gün), gerçek modda -1
+    double a;              // Malzeme maliyeti / toplam maliyet
+    double b;              // İşçilik maliyeti
+} __attribute__((aligned(CACHE_LINE)));
+
+// Çok yazarlı, tek okuyuculu (MPSC) kilitsiz halka; thread'ler ve kat süreçleri yazar, boşaltıcı okur
+struct LogRing {
+    _Atomic uint64_t tail __attribute__((aligned(CACHE_LINE))); // Sonraki yazma konumu (yazarlar arasında)
+    _Atomic uint64_t head __attribute__((aligned(CACHE_LINE))); // Sonraki okuma konumu (yalnızca boşaltıcı)
+    _Atomic uint64_t full_waits;                                // Halka dolu olduğu için bekleyen yazma sayısı
+    struct LogRecord cells[LOG_RING_SIZE];                      // Kayıt hücreleri
+};
+
+#define MAILBOX_SLOTS 64      // Posta kutusu yuvası (2'nin kuvveti): okuyucu yazarların en fazla bu kadar gerisinde kalabilir
+#define FLOOR_QUEUE_SLOTS 64  // Kat işi kuyruğu yuvası (2'nin kuvveti); kuyrukta en fazla işçi + hazır kat kadar iş olur
+#define MAX_FLOOR_PROCS 32    // --floor-procs üst sınırı (yuvalar ve posta kutusu taşmasın)
+#define FLOOR_COST_STEPS 8    // Bildirimde maliyeti taşınan kat adımı sınırı
+
+// Kat sürecinden ana sürece giden bildirim. Kat süreci maliyetini deftere kendisi yazmaz, adım
+// başına kuruş olarak burada taşır; ana süreç bildirimi alınca işler. Bildirmeden ölen denemenin
+// maliyeti böylece deftere hiç girmez.
+struct FloorMessage {
+    int32_t floor;       // Biten kat
+    int32_t status;      // 0: başarılı
+    int64_t material[FLOOR_COST_STEPS]; // Adım başına malzeme maliyeti (kuruş)
+    int64_t labor[FLOOR_COST_STEPS];    // Adım başına işçilik maliyeti (kuruş)
+    uint64_t posted_ns;  // Gönderildiği an (monotonic_ns; devir gecikmesini ölçmek için)
+};
+
+// Posta kutusu yuvası: seq == i + 1 olduğunda yuvada i. mesaj vardır
+struct MailSlot {
+    _Atomic uint32_t seq;
+    struct FloorMessage msg;
+};
+
+// Süreçler arası çok yazarlı, tek okuyuculu posta kutusu. Yazar reserved'dan sıra numarası i
+// alır, mesajı i % MAILBOX_SLOTS yuvasına yazıp yuvayı yayınlar ve posted'ı artırır; posted
+// okuyucunun uyuduğu futex sözcüğüdür. Okuyucu mesajları varış sırasıyla 0, 1, 2... alır.
+struct Mailbox {
+    _Atomic uint32_t reserved;             // Dağıtılan sıra numarası sayısı
+    _Atomic uint32_t posted;               // Yayınlanmış mesaj sayısı (futex sözcüğü)
+    _Atomic uint32_t waiters;              // Futex'te uyuyan okuyucu sayısı (yoksa uyandırma çağrısı yapılmaz)
+    struct MailSlot slots[MAILBOX_SLOTS];  // Mesaj yuvaları
+};
+
+// Kalıcı kat işçilerinin (--floor-procs) iş kuyruğu: tek yazar (ana süreç), çok okuyucu.
+// Yazar yuvayı doldurup pushed'ı artırır; okuyucular popped'ı CAS ile ilerleterek iş alır.
+// Negatif iş, işçiye çıkmasını söyler.
+struct FloorQueue {
+    _Atomic uint32_t pushed;                 // Kuyruğa konan iş sayısı (futex sözcüğü)
+    _Atomic uint32_t popped;                 // Alınan iş sayısı
+    _Atomic uint32_t waiters;                // Futex'te uyuyan işçi sayısı
+    _Atomic int32_t slots[FLOOR_QUEUE_SLOTS]; // Kat numaraları
+};
+
+// Paylaşılan bellekte maliyetleri saklamak için struct yapısı; daire dizileri (UnitArrays) hemen arkasından gelir
 struct SharedData {
-    float total_cost;                 // Toplam inşaat maliyeti
-    float foundation_material_cost;    // Temel için malzeme maliyeti
-    float foundation_labor_cost;      // Temel için işçilik maliyeti
-    float floor_material_cost;        // Kat inşaatı için malzeme maliyeti
-    float floor_labor_cost;           // Kat inşaatı için işçilik maliyeti
-    float electrical_material_cost;   // Elektrik tesisatı malzeme maliyeti
-    float electrical_labor_cost;      // Elektrik tesisatı işçilik maliyeti
-    float plumbing_material_cost;     // Sıhhi tesisat malzeme maliyeti
-    float plumbing_labor_cost;        // Sıhhi tesisat işçilik maliyeti
-    float painting_material_cost;     // Boya malzeme maliyeti
-    float painting_labor_cost;        // Boya işçilik maliyeti
-    float flooring_material_cost;     // Zemin kaplama malzeme maliyeti
-    float flooring_labor_cost;        // Zemin kaplama işçilik maliyeti
-    float window_material_cost;       // Pencere montajı malzeme maliyeti
-    float window_labor_cost;          // Pencere montajı işçilik maliyeti
-    float kitchen_material_cost;      // Mutfak dolabı malzeme maliyeti
-    float kitchen_labor_cost;         // Mutfak dolabı işçilik maliyeti
-    float bathroom_material_cost;     // Banyo montajı malzeme maliyeti
-    float bathroom_labor_cost;        // Banyo montajı işçilik maliyeti
-    float cleaning_material_cost;     // Son temizlik malzeme maliyeti
-    float cleaning_labor_cost;        // Son temizlik işçilik maliyeti
-    float roof_material_cost;         // Çatı ve ortak alanlar malzeme maliyeti
-    float roof_labor_cost;            // Çatı ve ortak alanlar işçilik maliyeti
-    pthread_mutex_t cost_mutex;       // Maliyet güncellemeleri için mutex
+    struct CostShard shards[COST_SHARDS];  // Yazar başına maliyet dilimleri
+    atomic_flag shard_taken[COST_SHARDS];  // Dilimin şu an bir yazara ait olup olmadığı
+    struct CostShard overflow;             // Tüm dilimler doluyken kilitle paylaşılan dilim
+    pthread_mutex_t cost_mutex;            // Yalnızca taşma dilimini korumak için mutex
+    struct Mailbox floor_mail;             // Kat süreçlerinin ana sürece "kat bitti" bildirimleri
+    struct FloorQueue floor_work;          // Kalıcı kat işçilerine dağıtılan katlar
+    _Atomic int32_t floor_worker_job[MAX_FLOOR_PROCS]; // İşçinin üzerinde çalıştığı kat (-1: boşta)
+    _Atomic int32_t crash_floor;           // Hata enjeksiyonu: bu kat ilk denemesinde çöker (-1: yok)
+    struct LogRing log;                    // Süreçler arası günlük halkası
+};
+
+#define UNIT_LANES 8              // Maliyet matrisinin vektör genişliği (hücre); sütunlar bu sayıya hizalıdır
+
+// Daire başına ilerleme ve maliyet. Her alan paylaşılan eşlemede kendi bitişik dizisindedir
+// (yapı dizisi yerine dizi yapısı, SoA); daire indeksi kat * apartments_per_floor + daire.
+// Maliyet matrisi kat x daire x kategoridir: daire adımlarının her kategorisi için bir sütun,
+// sütunda daire indeksi sırasıyla hücreler (kuruş, malzeme + işçilik). Kat ve daire eksenleri
+// sütun içinde bitişik olduğundan her eksende toplama vektör komutlarıyla yapılır.
+struct UnitArrays {
+    _Atomic uint8_t *progress;  // Biten adım sayısı
+    int32_t *cost;              // Maliyet matrisi: cost[sütun * stride + daire] (kuruş)
+    int64_t *shell;             // Kat başına kaba inşaat maliyeti (kuruş); matrisin hemen arkasında
+    long stride;                // Sütun uzunluğu: daire sayısı UNIT_LANES'e yuvarlanmış (dolgu hücreleri 0)
+    long count;                 // Daire sayısı
+};
+
+// Simülasyonun çalışma modları
+enum RunMode {
+    MODE_WALLCLOCK,   // Gerçek zamanlı mod: gecikmeler nanosleep ile gerçekten beklenir (demo için)
+    MODE_VIRTUAL      // Sanal zamanlı mod: gecikmeler ayrık olay zamanlayıcısında sanal saati ilerletir
+};
+
+// İş adımlarının süresince tuttuğu ortak kaynaklar (ekipler ve asansör)
+enum ResourceId {
+    RES_NONE = -1,    // Kaynak gerektirmeyen adım
+    RES_ELECTRIC,     // Elektrik ekipleri
+    RES_PLUMBING,     // Sıhhi tesisat ekipleri
+    RES_PAINT,        // Boya ekipleri
+    RES_ELEVATOR,     // Asansörler
+    RES_COUNT         // Kaynak sayısı
+};
+
+// Kaynak başına varsayılan ekip sayısı ve ekip-gün ücreti (TL); --crews, --crew-costs ya da yapılandırma dosyasıyla değişir
+#define DEFAULT_CREWS 1
+#define DEFAULT_CREW_DAY_COSTS { 2500, 2500, 2000, 1500 }
+#define MAX_CREWS 64
+
+// Mutfak malzemesinin daireye taşınma politikası (--deliveries)
+enum DeliveryMode {
+    DELIVERY_BATCH,   // İstekler kuyrukta toplanır; asansör seferi kat ve kapasiteye göre birden çok daireye
+                      // uğrar, kuyruk uzunsa alçak katlar merdiveni kullanır
+    DELIVERY_SINGLE   // Her sefer tek daireye gider, merdiven kullanılmaz (varsayılan)
+};
+
+// Taşıma süreleri (gün; gerçek modda saniye). Sefer süresi kat uzaklığına bağlıdır.
+#define DEFAULT_ELEVATOR_CAPACITY 4  // Bir seferde taşınan daire malzemesi (--elevator-capacity)
+#define MAX_ELEVATOR_CAPACITY 16
+#define ELEVATOR_LOAD_DAYS 0.04      // Bir dairenin malzemesini kabine yükleme
+#define ELEVATOR_FLOOR_DAYS 0.015    // Asansörün bir kat çıkması ya da inmesi
+#define ELEVATOR_STOP_DAYS 0.03      // Bir katta durup malzemeyi indirme
+#define STAIRS_BASE_DAYS 0.1         // Merdivenle taşımanın hazırlığı
+#define STAIRS_FLOOR_DAYS 0.1        // Malzemeyi merdivenle bir kat çıkarma
+#define DELIVERY_WINDOW 64           // Sefer toplanırken bakılan en eski istek sayısı
+#define DEFAULT_DELIVERY_HOLD 0.0    // Boş asansörün kabin dolsun diye bekleyebileceği süre (--delivery-hold)
+
+// İnşaattaki iş türleri; her biri sırayla çalışan adımlardan oluşur
+enum JobKind {
+    JOB_FOUNDATION,     // Temel atma
+    JOB_FLOOR,          // Kat kaba inşaatı
+    JOB_ROOF_SKELETON,  // Çatı iskeleti
+    JOB_APARTMENT,      // Daire iç dizaynı
+    JOB_ROOF,           // Çatı katı ve ortak alanlar
+    JOB_INTERIOR,       // Katın iç dizayn bitiş noktası (adımsız bağımlılık düğümü)
+    JOB_KIND_COUNT      // İş türü sayısı
+};
+
+// Bir iş adımının tanımı: mesajları, gecikme aralığı, maliyeti ve tuttuğu kaynak
+struct TaskStep {
+    const char *start_msg;     // Adım başlarken yazdırılan mesaj
+    const char *done_msg;      // Adım bitince yazdırılan mesaj (NULL ise yazdırılmaz)
+    const char *color;         // Mesaj rengi (NULL ise renksiz)
+    double min_sec;            // En kısa süre (gerçek modda saniye, sanal modda gün)
+    double max_sec;            // En uzun süre
+    double material_cost;      // Varsayılan malzeme fiyatı (fiyat tablosunun başlangıç değeri)
+    enum CostCategory category; // Maliyet kategorisi
+    enum ResourceId resource;  // Adım süresince tutulan kaynak
+    int per_floor;             // 1 ise malzeme maliyeti kat sayısıyla çarpılır
+    const char *price_key;     // Fiyat dosyasındaki anahtar (NULL: fiyatı dosyadan değiştirilemez)
+};
+
+// Temel atma adımları (maliyet kürleme bitince bir kez eklenir)
+static const struct TaskStep foundation_steps[] = {
+    { "Zemin etüdü yapılıyor...",   NULL, NULL, 1.0, 2.0, 0.0, CAT_FOUNDATION, RES_NONE, 0, NULL },
+    { "Temel kazısı başladı...",    NULL, NULL, 2.0, 3.0, 0.0, CAT_FOUNDATION, RES_NONE, 0, NULL },
+    { "Temel betonu dökülüyor...",  NULL, NULL, 1.5, 2.5, 0.0, CAT_FOUNDATION, RES_NONE, 0, NULL },
+    { "Temel kürleniyor...",        NULL, NULL, 3.0, 5.0, 150000.0, CAT_FOUNDATION, RES_NONE, 0, "foundation" },
+};
+
+// Kat kaba inşaatı adımları
+static const struct TaskStep floor_steps[] = {
+    { "Temel yapı çalışmaları başladı...", NULL, NULL, 1.0, 2.0, 10000.0, CAT_FLOOR, RES_NONE, 0, "floor_base" },
+    { "Kolon ve kirişler yapılıyor...",    NULL, NULL, 1.5, 2.5, 15000.0, CAT_FLOOR, RES_NONE, 0, "floor_columns" },
+    { "Duvarlar örülüyor...",              NULL, NULL, 1.0, 2.0, 8000.0, CAT_FLOOR, RES_NONE, 0, "floor_walls" },
+    { "Koridor ve merdivenler yapılıyor...", NULL, NULL, 0.5, 1.0, 5000.0, CAT_FLOOR, RES_NONE, 0, "floor_stairs" },
+};
+
+// Çatı iskeleti adımı (maliyet kat başınadır)
+static const struct TaskStep roof_skeleton_steps[] = {
+    { "İskelet yapımı devam ediyor...", "İskelet yapımı tamamlandı.", COLOR_RED, 2.0, 3.0,
+      6000.0, CAT_ROOF, RES_NONE, 1, "roof_skeleton" },
+};
+
+// Daire iç dizaynı adımları; elektrik, sıhhi tesisat ve boya tek ekiple, taşıma tek asansörle yapılır
+static const struct TaskStep apartment_steps[] = {
+    { "Elektrik tesisatı yapılıyor...", "Elektrik tesisatı tamamlandı.", COLOR_YELLOW, 0.3, 0.7, 3000.0, CAT_ELECTRICAL, RES_ELECTRIC, 0, "electrical" },
+    { "Sıhhi tesisat yapılıyor...",     "Sıhhi tesisat tamamlandı.",     COLOR_BLUE,   0.3, 0.6, 2000.0, CAT_PLUMBING,   RES_PLUMBING, 0, "plumbing" },
+    { "Boya yapılıyor...",              "Boya tamamlandı.",              COLOR_MAGENTA, 0.5, 1.0, 1500.0, CAT_PAINTING,  RES_PAINT, 0, "painting" },
+    { "Zemin kaplaması yapılıyor...",   "Zemin kaplaması tamamlandı.",   COLOR_GREEN,  0.5, 1.0, 1000.0, CAT_FLOORING,   RES_NONE, 0, "flooring" },
+    { "Pencere montajı yapılıyor...",   "Pencere montajı tamamlandı.",   NULL,         0.4, 0.9, 500.0, CAT_WINDOW,     RES_NONE, 0, "window" },
+    { "Mutfak dolabı malzemesi asansörle taşınıyor...", NULL,            COLOR_RED,    0.2, 0.4, 0.0, CAT_KITCHEN,    RES_ELEVATOR, 0, "kitchen_delivery" },
+    { "Mutfak dolabı montajı yapılıyor...", "Mutfak dolabı montajı tamamlandı.", COLOR_RED, 0.5, 1.0, 5000.0, CAT_KITCHEN, RES_NONE, 0, "kitchen" },
+    { "Banyo montajı yapılıyor...",     "Banyo montajı tamamlandı.",     COLOR_YELLOW, 0.5, 1.0, 4000.0, CAT_BATHROOM,   RES_NONE, 0, "bathroom" },
+    { "Son temizlik yapılıyor...",      "Son temizlik tamamlandı.",      NULL,         0.2, 0.5, 300.0, CAT_CLEANING,   RES_NONE, 0, "cleaning" },
+};
+
+// Çatı katı ve ortak alan adımları
+static const struct TaskStep roof_steps[] = {
+    { "Çatı yapımı devam ediyor...",             NULL, NULL, 2.0, 3.0, 30000.0, CAT_ROOF, RES_NONE, 0, "roof" },
+    { "Asansör sistemleri kuruluyor...",         NULL, NULL, 1.0, 2.0, 30000.0, CAT_ROOF, RES_NONE, 0, "elevator_system" },
+    { "Ortak alanların dekorasyonu yapılıyor...", NULL, NULL, 1.5, 2.5, 20000.0, CAT_ROOF, RES_NONE, 0, "common_areas" },
+};
+
+// Her iş türünün adım listesi
+struct JobProgram {
+    const struct TaskStep *steps; // Adım dizisi
+    int step_count;               // Adım sayısı
+};
+
+#define STEPS(arr) { arr, (int)(sizeof(arr) / sizeof(arr[0])) }
+static const struct JobProgram job_programs[JOB_KIND_COUNT] = {
+    [JOB_FOUNDATION]    = STEPS(foundation_steps),
+    [JOB_FLOOR]         = STEPS(floor_steps),
+    [JOB_ROOF_SKELETON] = STEPS(roof_skeleton_steps),
+    [JOB_APARTMENT]     = STEPS(apartment_steps),
+    [JOB_ROOF]          = STEPS(roof_steps),
+    [JOB_INTERIOR]      = { NULL, 0 },
+};
+_Static_assert(sizeof(floor_steps) / sizeof(floor_steps[0]) <= FLOOR_COST_STEPS, "kat adımları bildirime sığmalı");
+
+// Fiyat tablosu: adım başına birim malzeme fiyatı, kategori başına işçilik oranı ve ekip-gün
+// ücreti. Adım tablolarındaki değerlerle başlar, --prices dosyasıyla çalışma anında değişir.
+// Defter her adımın tükettiği miktarı da tuttuğundan, --what-if fiyatlarıyla toplam maliyet
+// koşu tekrarlanmadan miktarlardan yeniden hesaplanır.
+struct PriceTable {
+    double material[MAX_PRICE_ITEMS];    // Fiyat kalemi (adım) başına birim malzeme fiyatı (TL)
+    double labor_ratio[CAT_COUNT];       // İşçiliğin malzemeye oranı
+    double crew_day[RES_COUNT];          // Ekip-gün ücreti (TL)
 };
 
+#define DEFAULT_LABOR_RATIO 0.4          // İşçilik, malzeme maliyetinin %40'ı
+
+static struct PriceTable prices;         // Koşunun fiyatları
+static int price_item_base[JOB_KIND_COUNT]; // İş türünün ilk adımının fiyat kalemi
+static int price_item_count;             // Toplam fiyat kalemi
+
+// Adımın fiyat kalemi
+static inline int price_item(enum JobKind kind, int step_index) {
+    return price_item_base[kind] + step_index;
+}
+
 // Senkronizasyon nesneleri
-sem_t *floor_semaphore[TOTAL_FLOORS]; // Her kat için semafor dizisi
-sem_t elevator_sem;                    // Asansör erişimi için semafor
-sem_t stairs_sem;                     // Merdiven erişimi için semafor
+sem_t resource_sem[RES_COUNT];         // Kaynak başına sayan semafor (değeri boştaki ekip ya da asansör sayısı)
 
 // Global değişkenler
-struct SharedData *shared_data; // Paylaşılan bellek pointer'ı
-int construction_day = 1;       // Simülasyonda geçerli gün sayısı
+struct SharedData *shared_data;    // Paylaşılan bellek pointer'ı
+static size_t shared_size;         // Paylaşılan eşlemenin boyutu (SharedData + daire dizileri)
+struct UnitArrays units;           // Paylaşılan bellekteki daire dizileri
+static int unit_column[CAT_COUNT]; // Kategorinin maliyet matrisindeki sütunu (-1: daire adımı yok)
+static enum CostCategory unit_column_category[CAT_COUNT]; // Sütunun kategorisi
+static int unit_column_count;      // Matris sütunu sayısı (daire adımlarındaki farklı kategoriler)
+int total_floors = DEFAULT_FLOORS; // Kat sayısı
+int apartments_per_floor = DEFAULT_APARTMENTS_PER_FLOOR; // Kattaki daire sayısı
+int total_days = DEFAULT_TOTAL_DAYS; // Planlanan gün sayısı
+atomic_int construction_day = 1;   // Simülasyonda geçerli gün sayısı (havuz thread'leri de artırır)
+enum RunMode run_mode = MODE_WALLCLOCK; // Seçili çalışma modu
+static __thread double virtual_now = 0.0; // Sanal modda geçerli simülasyon zamanı (gün); her kopyanın kendi thread'inde
+enum LogLevel log_level = LOG_LEVEL_TASK; // Günlük seviyesi
+static FILE *log_out;              // Boşaltıcının yazdığı akış (varsayılan stdout)
+static pthread_t log_drainer;      // Halkayı boşaltan thread
+static atomic_int log_stop;        // Boşaltıcıya durma isteği
+static int log_drainer_running;    // Boşaltıcı başlatıldı mı
+static pid_t log_pid;              // Kayıtlara yazılan PID (getpid her kayıtta sistem çağrısı olmasın)
+static unsigned long virtual_events; // Sanal modda işlenen olay sayısı
+static long bench_log_events;      // --bench-log ile istenen thread başına olay sayısı (0: kıyaslama yok)
+static int pool_workers;           // İş havuzundaki işçi sayısı (0: donanım eşzamanlılığı)
+static uint64_t run_seed;          // Ana tohum (--seed); tüm akışlar bundan türetilir
+static int seed_given;             // --seed verildi mi
+static long batch_replicas;        // --batch ile istenen kopya sayısı (0: tek çalıştırma)
+int crew_counts[RES_COUNT] = { DEFAULT_CREWS, DEFAULT_CREWS, DEFAULT_CREWS, DEFAULT_CREWS }; // Kaynak başına ekip sayısı
+double crew_day_costs[RES_COUNT] = DEFAULT_CREW_DAY_COSTS; // Kaynak başına ekip-gün ücreti (TL; kuruşlu olabilir)
+static int tune_max_crews;         // --tune ile denenecek en fazla ekip sayısı (0: eniyileme yok)
+static double delay_scale = 1.0;   // Gerçek moddaki gecikmelerin çarpanı (--delay-scale; 0: beklemeden)
+static unsigned bench_suites;      // --bench ile seçilen kıyaslamalar (bit maskesi, 0: kıyaslama yok)
+static int crash_floor;            // --crash-floor ile ilk denemesinde çökecek kat (1 tabanlı, 0: yok)
+static const char *checkpoint_path; // --checkpoint ile kontrol noktası dosyası (NULL: yazılmaz)
+static long checkpoint_every = 1000000; // Kontrol noktaları arası olay sayısı (--checkpoint-every)
+static const char *resume_path;    // --resume ile devam edilecek kontrol noktası
+static double halt_at_day;         // --halt-at: sanal saat bu güne gelince süreç kendini öldürür (0: yok)
+static const char *analyze_path;   // --analyze ile çözümlenecek olay günlüğü
+static int portfolio_sites;        // --sites ile portföydeki şantiye sayısı (0: tek bina)
+static int portfolio_regions = 1;  // --regions: ekip havuzu paylaşan bölge sayısı (1: tek küresel havuz)
+static double travel_days = 0.5;   // --travel-days: ekibin şantiye değiştirirken yolda geçirdiği gün
+static const char *prices_path;    // --prices ile verilen fiyat dosyası
+static int top_interval_ms;        // --top: koşan simülasyonu izleme aralığı (0: izleyici değil, simülasyon)
+static enum DeliveryMode delivery_mode = DELIVERY_SINGLE;   // --deliveries (toplu taşıma kazanç gösterene dek tek tek)
+static int elevator_capacity = DEFAULT_ELEVATOR_CAPACITY;  // --elevator-capacity
+static double delivery_hold = DEFAULT_DELIVERY_HOLD;       // --delivery-hold (gün; gerçek modda saniye)
+
+// Rastgele akış numaraları: kopyalar 0..N-1 (tek çalıştırma 0. kopyadır), tembel tohumlanan
+// havuz thread'leri RNG_STREAM_THREAD'den, fork edilen kat süreçleri RNG_STREAM_PROCESS'ten başlar
+#define RNG_STREAM_THREAD  (1ULL << 40)
+#define RNG_STREAM_PROCESS (1ULL << 41)
+
+// xoshiro256** üreteci; durum ana tohum ve akış numarasından splitmix64 ile türetilir,
+// böylece her akış diğerlerinden bağımsız ve yalnızca (tohum, akış) ikilisine bağlıdır
+struct RngStream {
+    uint64_t s[4];
+};
+
+static __thread struct RngStream rng;   // Bu thread'in akışı
+static __thread int rng_ready;          // Akış tohumlandı mı
+static atomic_ulong rng_thread_streams; // Tembel tohumlanan thread sayısı
+
+// splitmix64 adımı: x'i ilerletir ve karıştırılmış 64 bit döndürür
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Akışı (tohum, akış numarası) ikilisinden hazırlar
+void rng_init(struct RngStream *r, uint64_t seed, uint64_t stream) {
+    uint64_t mix = stream;
+    uint64_t x = seed ^ splitmix64(&mix); // Akış numarasını karıştırıp tohuma kat
+    for (int i = 0; i < 4; i++) r->s[i] = splitmix64(&x);
+}
+
+// Sonraki 64 bitlik sayıyı üretir
+static uint64_t rng_next(struct RngStream *r) {
+    uint64_t *s = r->s;
+    uint64_t x = s[1] * 5;
+    uint64_t result = ((x << 7) | (x >> 57)) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+    return result;
+}
+
+// Bu thread'i ana tohumun verilen akışına ayarlar
+void random_stream(uint64_t stream) {
+    rng_init(&rng, run_seed, stream);
+    rng_ready = 1;
+}
+
+// fork sonrası çocuk süreç ebeveyninin akışını tekrarlamamalı: akış PID'den seçilir
+static void random_atfork_child(void) {
+    random_stream(RNG_STREAM_PROCESS + (uint64_t)getpid());
+}
+
+// Rastgele sayı üreticisini başlatır; ana thread 0. akışı kullanır
+void random_init(uint64_t seed) {
+    run_seed = seed;
+    random_stream(0);
+    pthread_atfork(NULL, NULL, random_atfork_child);
+}
+
+// Rastgele süre fonksiyonu: [min_sec, max_sec] aralığında rastgele bir süre üretir.
+// Her thread kendi akışını kullanır; kilit yoktur ve sanal modda sonuç tohumla tekrarlanabilir.
+double random_duration(double min_sec, double max_sec) {
+    if (!rng_ready) random_stream(RNG_STREAM_THREAD + atomic_fetch_add(&rng_thread_streams, 1));
+    double u = (rng_next(&rng) >> 11) * 0x1.0p-53; // [0, 1) aralığında 53 bitlik kesir
+    return min_sec + u * (max_sec - min_sec);
+}
 
 // Rastgele gecikme fonksiyonu: İnşaat süreçlerini simüle etmek için rastgele bekleme süresi
 void random_delay(double min_sec, double max_sec) {
-    double sec = min_sec + (rand() / (double)RAND_MAX) * (max_sec - min_sec); // Rastgele süre hesapla
+    double sec = random_duration(min_sec, max_sec) * delay_scale;             // Rastgele süre hesapla
+    if (sec <= 0.0) return;                                                   // Gecikmeler kapalı (kıyaslama)
     struct timespec ts = {
         .tv_sec = (time_t)sec,                                                // Saniye cinsinden tam sayı kısmı
         .tv_nsec = (long)((sec - (time_t)sec) * 1e9)                          // Nanosaniye cinsinden ondalık kısmı
@@ -71,504 +478,5919 @@ void random_delay(double min_sec, double max_sec) {
     nanosleep(&ts, NULL); // Belirtilen süre kadar bekle
 }
 
-// Maliyet ekleme fonksiyonu: Malzeme ve işçilik maliyetlerini paylaşılan belleğe kaydeder
-void add_cost(float material_cost, float labor_cost, char* category) {
-    pthread_mutex_lock(&shared_data->cost_mutex);            // Maliyet güncellemesi için mutex kilitle
-    shared_data->total_cost += (material_cost + labor_cost); // Toplam maliyete ekle
-
-    // Kategoriye göre ilgili maliyet alanlarını güncelleme kısmı
-    if (strcmp(category, "foundation") == 0) {
-        shared_data->foundation_material_cost += material_cost;
-        shared_data->foundation_labor_cost += labor_cost;
-    } else if (strcmp(category, "floor") == 0) {
-        shared_data->floor_material_cost += material_cost;
-        shared_data->floor_labor_cost += labor_cost;
-    } else if (strcmp(category, "electrical") == 0) {
-        shared_data->electrical_material_cost += material_cost;
-        shared_data->electrical_labor_cost += labor_cost;
-    } else if (strcmp(category, "plumbing") == 0) {
-        shared_data->plumbing_material_cost += material_cost;
-        shared_data->plumbing_labor_cost += labor_cost;
-    } else if (strcmp(category, "painting") == 0) {
-        shared_data->painting_material_cost += material_cost;
-        shared_data->painting_labor_cost += labor_cost;
-    } else if (strcmp(category, "flooring") == 0) {
-        shared_data->flooring_material_cost += material_cost;
-        shared_data->flooring_labor_cost += labor_cost;
-    } else if (strcmp(category, "window") == 0) {
-        shared_data->window_material_cost += material_cost;
-        shared_data->window_labor_cost += labor_cost;
-    } else if (strcmp(category, "kitchen") == 0) {
-        shared_data->kitchen_material_cost += material_cost;
-        shared_data->kitchen_labor_cost += labor_cost;
-    } else if (strcmp(category, "bathroom") == 0) {
-        shared_data->bathroom_material_cost += material_cost;
-        shared_data->bathroom_labor_cost += labor_cost;
-    } else if (strcmp(category, "cleaning") == 0) {
-        shared_data->cleaning_material_cost += material_cost;
-        shared_data->cleaning_labor_cost += labor_cost;
-    } else if (strcmp(category, "roof") == 0) {
-        shared_data->roof_material_cost += material_cost;
-        shared_data->roof_labor_cost += labor_cost;
-    }
-
-    // Maliyet güncellemesini konsola yazdırma
-    printf("Kategori: %s, Malzeme maliyeti: %.2f TL, İşçilik maliyeti: %.2f TL, Yeni toplam: %.2f TL\n",
-           category, material_cost, labor_cost, shared_data->total_cost);
-    pthread_mutex_unlock(&shared_data->cost_mutex); // Mutex kilidini aç
+// Bu thread'in (ya da sürecin) yazdığı maliyet dilimi; -1 henüz dilim alınmadı demektir
+static __thread int cost_shard = -1;
+static pthread_key_t cost_shard_key;  // Thread bittiğinde dilimi geri vermek için anahtar
+
+// Boş bir maliyet dilimi alır; hepsi doluysa COST_SHARDS (taşma dilimi) döner
+static int cost_shard_claim(void) {
+    for (int i = 0; i < COST_SHARDS; i++) {
+        if (!atomic_flag_test_and_set(&shared_data->shard_taken[i])) return i;
+    }
+    return COST_SHARDS;
 }
 
-// Gün bilgisini ve o güne kadar olan toplam maliyeti yazdıran fonksiyon
-void print_day_info() {
-    printf(COLOR_CYAN "\n=== GÜN %d === (Toplam Maliyet: %.2f TL)\n" COLOR_RESET,
-           construction_day++, shared_data->total_cost); // Gün sayısını artır ve toplam maliyeti yaz
-}
-
-// Daire işlemleri için gerekli fonksiyonlar
-// Elektrik tesisatı fonksiyonu
-void electrical_work(int floor, int apartment) {
-    static pthread_mutex_t electric_mutex = PTHREAD_MUTEX_INITIALIZER; // Elektrik işlemleri için statik mutex
-    pthread_mutex_lock(&electric_mutex);                               // Aynı anda tek elektrik işlemi yapılması sağlanır
-    printf(COLOR_YELLOW "[Kat %d Daire %d] Elektrik tesisatı yapılıyor...\n" COLOR_RESET, floor+1, apartment+1);
-    random_delay(0.3, 0.7);                                            // Rastgele gecikme ile işlemi simüle et
-    printf(COLOR_YELLOW "[Kat %d Daire %d] Elektrik tesisatı tamamlandı.\n" COLOR_RESET, floor+1, apartment+1);
-    pthread_mutex_unlock(&electric_mutex);                             // Mutex kilidini aç
-    float material_cost = 3000.0f;                                     // Malzeme maliyeti
-    float labor_cost = material_cost * 0.4;                            // İşçilik maliyeti (malzeme maaliyetinin %40)
-    add_cost(material_cost, labor_cost, "electrical");                 // Maliyeti ekle
-}
-
-// Sıhhi tesisat fonksiyonu
-void plumbing_work(int floor, int apartment) {
-    static pthread_mutex_t plumbing_mutex = PTHREAD_MUTEX_INITIALIZER; // Sıhhi tesisat için statik mutex
-    pthread_mutex_lock(&plumbing_mutex);                               // Aynı anda tek sıhhi tesisat işlemi yapılması sağlanır
-    printf(COLOR_BLUE "[Kat %d Daire %d] Sıhhi tesisat yapılıyor...\n" COLOR_RESET, floor+1, apartment+1);
-    random_delay(0.3, 0.6);                                            // Rastgele gecikme
-    printf(COLOR_BLUE "[Kat %d Daire %d] Sıhhi tesisat tamamlandı.\n" COLOR_RESET, floor+1, apartment+1);
-    pthread_mutex_unlock(&plumbing_mutex); // Mutex kilidini aç
-    float material_cost = 2000.0f;                                     // Malzeme maliyeti
-    float labor_cost = material_cost * 0.4;                            // İşçilik maliyeti
-    add_cost(material_cost, labor_cost, "plumbing");                   // Maliyeti ekle
-}
-
-// Boya fonksiyonu
-void painting_work(int floor, int apartment) {
-    static pthread_mutex_t paint_mutex = PTHREAD_MUTEX_INITIALIZER; // Boya için statik mutex
-    pthread_mutex_lock(&paint_mutex);                               // Aynı anda tek boya işlemi yapılması sağlanır
-    printf(COLOR_MAGENTA "[Kat %d Daire %d] Boya yapılıyor...\n" COLOR_RESET, floor+1, apartment+1);
-    random_delay(0.5, 1.0);                                         // Rastgele gecikme
-    printf(COLOR_MAGENTA "[Kat %d Daire %d] Boya tamamlandı.\n" COLOR_RESET, floor+1, apartment+1);
-    pthread_mutex_unlock(&paint_mutex);                             // Mutex kilidini aç
-    float material_cost = 1500.0f;                                  // Malzeme maliyeti
-    float labor_cost = material_cost * 0.4;                         // İş последние
-    add_cost(material_cost, labor_cost, "painting");                // Maliyeti ekle
-}
-
-// Zemin kaplama fonksiyonu
-void flooring_work(int floor, int apartment) {
-    printf(COLOR_GREEN "[Kat %d Daire %d] Zemin kaplaması yapılıyor...\n" COLOR_RESET, floor+1, apartment+1);
-    random_delay(0.5, 1.0);                                         // Rastgele gecikme
-    printf(COLOR_GREEN "[Kat %d Daire %d] Zemin kaplaması tamamlandı.\n" COLOR_RESET, floor+1, apartment+1);
-    float material_cost = 1000.0f;                                  // Malzeme maliyeti
-    float labor_cost = material_cost * 0.4;                         // İşçilik maliyeti
-    add_cost(material_cost, labor_cost, "flooring");                // Maliyeti ekle
-}
-
-// Pencere montajı fonksiyonu
-void window_installation(int floor, int apartment) {
-    printf("[Kat %d Daire %d] Pencere montajı yapılıyor...\n", floor+1, apartment+1);
-    random_delay(0.4, 0.9);                                         // Rastgele gecikme
-    printf("[Kat %d Daire %d] Pencere montajı tamamlandı.\n", floor+1, apartment+1);
-    float material_cost = 500.0f;                                   // Malzeme maliyeti
-    float labor_cost = material_cost * 0.4;                         // İşçilik maliyeti
-    add_cost(material_cost, labor_cost, "window");                  // Maliyeti ekle
-}
-
-// Mutfak dolabı montajı fonksiyonu
-void kitchen_cabinet(int floor, int apartment) {
-    sem_wait(&elevator_sem);                                        // Asansör erişimi için semafor bekle
-    printf(COLOR_RED "[Kat %d Daire %d] Mutfak dolabı malzemesi asansörle taşınıyor...\n" COLOR_RESET, floor+1, apartment+1);
-    random_delay(0.2, 0.4);                                         // Asansör taşıma süresi
-    sem_post(&elevator_sem);                                        // Asansör semaforunu serbest bırak
-
-    printf(COLOR_RED "[Kat %d Daire %d] Mutfak dolabı montajı yapılıyor...\n" COLOR_RESET, floor+1, apartment+1);
-    random_delay(0.5, 1.0);                                         // Montaj süresi
-    printf(COLOR_RED "[Kat %d Daire %d] Mutfak dolabı montajı tamamlandı.\n" COLOR_RESET, floor+1, apartment+1);
-    float material_cost = 5000.0f;                                  // Malzeme maliyeti
-    float labor_cost = material_cost * 0.4;                         // İşçilik maliyeti
-    add_cost(material_cost, labor_cost, "kitchen");                 // Maliyeti ekle
-}
-
-// Banyo montajı fonksiyonu
-void bathroom_installation(int floor, int apartment) {
-    printf(COLOR_YELLOW "[Kat %d Daire %d] Banyo montajı yapılıyor...\n" COLOR_RESET, floor+1, apartment+1);
-    random_delay(0.5, 1.0);                                         // Rastgele gecikme
-    printf(COLOR_YELLOW "[Kat %d Daire %d] Banyo montajı tamamlandı.\n" COLOR_RESET, floor+1, apartment+1);
-    float material_cost = 4000.0f;                                  // Malzeme maliyeti
-    float labor_cost = material_cost * 0.4;                         // İşçilik maliyeti
-    add_cost(material_cost, labor_cost, "bathroom");                // Maliyeti ekle
-}
-
-// Son temizlik fonksiyonu
-void final_cleaning(int floor, int apartment) {
-    printf("[Kat %d Daire %d] Son temizlik yapılıyor...\n", floor+1, apartment+1);
-    random_delay(0.2, 0.5);                                         // Rastgele gecikme
-    printf("[Kat %d Daire %d] Son temizlik tamamlandı.\n", floor+1, apartment+1);
-    float material_cost = 300.0f;                                   // Malzeme maliyeti
-    float labor_cost = material_cost * 0.4;                         // İşçilik maliyeti
-    add_cost(material_cost, labor_cost, "cleaning");                // Maliyeti ekle
-}
-
-// Çatı iskeleti fonksiyonu
-void roof_skeleton() {
-    printf(COLOR_RED "[Çatı] İskelet yapımı devam ediyor...\n" COLOR_RESET);
-    random_delay(2.0, 3.0);                                         // Rastgele gecikme
-    float material_cost = 6000.0f * TOTAL_FLOORS;                   // Çatı maliyeti (kat sayısına bağlı)
-    float labor_cost = material_cost * 0.4;                         // İşçilik maliyeti
-    add_cost(material_cost, labor_cost, "roof");                    // Maliyeti ekle
-    printf(COLOR_RED "[Çatı] İskelet yapımı tamamlandı.\n" COLOR_RESET);
-}
-
-// Daire inşaatı için thread fonksiyonu
-void* apartment_construction(void* arg) {
-    int floor = ((int*)arg)[0];                                     // Kat numarasını al
-    int apartment = ((int*)arg)[1];                                 // Daire numarasını al
-    free(arg);                                                      // Dinamik olarak ayrılan argüman belleğini serbest bırak
-
-    printf("\n" COLOR_CYAN "--- Kat %d Daire %d iç dizayn başladı ---\n" COLOR_RESET, floor+1, apartment+1);
-
-    // Her dairenin iç dizaynı için tüm işlemler sırayla gerçekleştirilir
-    electrical_work(floor, apartment);
-    plumbing_work(floor, apartment);
-    painting_work(floor, apartment);
-    flooring_work(floor, apartment);
-    window_installation(floor, apartment);
-    kitchen_cabinet(floor, apartment);
-    bathroom_installation(floor, apartment);
-    final_cleaning(floor, apartment);
-
-    printf(COLOR_CYAN "--- Kat %d Daire %d iç dizayn tamamlandı ---\n\n" COLOR_RESET, floor+1, apartment+1);
-    return NULL;
+// Dilimi geri verir; içindeki tutarlar korunur, dilimi sonraki yazar kullanmaya devam eder
+void cost_shard_release(void) {
+    if (cost_shard >= 0 && cost_shard < COST_SHARDS) atomic_flag_clear(&shared_data->shard_taken[cost_shard]);
+    cost_shard = -1;
 }
 
-// Kat inşaatı fonksiyonu (kaba inşaat ve ortak alanlar)
-void floor_construction(int floor) {
-    printf("\n" COLOR_YELLOW "=== KAT %d KABA İNŞAATI BAŞLADI (PID: %d) ===\n" COLOR_RESET, floor+1, getpid());
+// Thread sonlanırken çağrılan anahtar yıkıcısı
+static void cost_shard_destructor(void *unused) {
+    (void)unused;
+    cost_shard_release();
+}
+
+// fork sonrası çocuk süreç ebeveynin dilimini paylaşmamalı: çocukta dilim sıfırlanır
+static void cost_shard_atfork_child(void) {
+    cost_shard = -1;
+}
+
+// Maliyet defterini hazırlayan fonksiyon (paylaşılan bellek eşlendikten sonra çağrılır)
+void cost_ledger_init(void) {
+    for (int i = 0; i < COST_SHARDS; i++) atomic_flag_clear(&shared_data->shard_taken[i]);
+    pthread_key_create(&cost_shard_key, cost_shard_destructor);
+    pthread_atfork(NULL, NULL, cost_shard_atfork_child);
+}
+
+// Tek yazarlı dilime kilitsiz ekleme (okuyucular yırtılmamış değer görür)
+static void shard_add(_Atomic double *slot, double value) {
+    atomic_store_explicit(slot, atomic_load_explicit(slot, memory_order_relaxed) + value, memory_order_relaxed);
+}
 
-    // Temel yapı çalışmaları
-    printf("[Kat %d] Temel yapı çalışmaları başladı...\n", floor+1);
-    random_delay(1.0, 2.0);                             // Rastgele gecikme
-    float material_cost1 = 10000.0f;                    // Malzeme maliyeti
-    float labor_cost1 = material_cost1 * 0.4;           // İşçilik maliyeti
-    add_cost(material_cost1, labor_cost1, "floor");     // Maliyeti ekle
+// Tek yazarlı dilime kuruş ekleme
+static void shard_add_kurus(_Atomic int64_t *slot, int64_t value) {
+    atomic_store_explicit(slot, atomic_load_explicit(slot, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+// Metni ekranda width sütun kaplayacak şekilde yazar (UTF-8 devam baytları sütun kaplamaz)
+static void print_padded(const char *text, int width) {
+    int columns = 0;
+    for (const char *c = text; *c; c++) columns += ((unsigned char)*c & 0xC0) != 0x80;
+    printf("%s%*s", text, width > columns ? width - columns : 0, "");
+}
+
+// Monoton saat (nanosaniye)
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// ---------------------------------------------------------------------------
+// İz kaydı (--trace=DOSYA): her işin ve adımın başlangıç/bitiş aralığı, kat bildirimi gönderme/bekleme
+// ve kaynak devri akış okları, kaynak beklemeleri Chrome trace-event JSON olarak yazılır
+// (chrome://tracing ya da ui.perfetto.dev ile açılır). Kayıtlar fork sonrası da görünen paylaşılan
+// bir alana, her thread'in (ya da kat sürecinin) kendine ayırdığı parçalara kilitsiz yazılır;
+// tek atomik işlem yeni parça alınırken yapılır. Sanal modda her iş kendi şeridinde (tid) görünür.
+// ---------------------------------------------------------------------------
+
+// İz olayının anlamı (yazarken adı ve kategorisi buradan seçilir)
+enum TraceWhat {
+    TRACE_JOB,            // İş aralığı (eşzamansız: daire adımları farklı işçilerde çalışabilir)
+    TRACE_STEP,           // Adım aralığı
+    TRACE_MAIL_POST,      // Kat bildirimini gönderme (akışın kaynağı)
+    TRACE_MAIL_WAIT,      // Kat bildirimini bekleme (akışın hedefi)
+    TRACE_RESOURCE_WAIT,  // Meşgul kaynağı bekleme
+    TRACE_HANDOFF,        // Sanal modda kaynağın sıradaki işe devri (akış)
+    TRACE_NAME            // Süreç ya da thread adı
+};
+
+// İsim olaylarının türleri
+enum TraceName {
+    TRACE_NAME_MAIN,      // Ana thread
+    TRACE_NAME_WORKER,    // Havuz işçisi
+    TRACE_NAME_FLOOR,     // Kat süreci
+    TRACE_NAME_FLOOR_WORKER, // Kalıcı kat işçisi süreci
+    TRACE_NAME_LANE       // Sanal moddaki iş şeridi
+};
+
+// Sabit boyutlu iz olayı
+struct TraceEvent {
+    uint64_t ts;          // Zaman (ns; sanal modda 1 gün = 1 sn)
+    uint64_t dur;         // Süre ('X' olayları)
+    int32_t pid;          // Süreç
+    int32_t tid;          // Thread (sanal modda iş şeridi)
+    int32_t floor;        // Kat
+    int32_t apartment;    // Daire
+    uint32_t id;          // Eşzamansız iş ya da akış kimliği
+    char phase;           // Chrome olay türü: B, E, X, b, e, s, f, M
+    uint8_t what;         // enum TraceWhat
+    uint8_t kind;         // İş türü, kaynak ya da isim türü
+    uint8_t index;        // Adım indeksi ya da şeridin iş türü
+};
+
+#define TRACE_CHUNK_EVENTS 128    // Parça başına olay sayısı
+#define TRACE_NS_PER_DAY 1e9      // Sanal modda bir günün iz süresi (gerçek moddaki bir saniyeye denk)
+
+// Bir yazarın kesintisiz doldurduğu parça
+struct TraceChunk {
+    int32_t used;                                 // Yazılmış olay sayısı
+    struct TraceEvent events[TRACE_CHUNK_EVENTS];
+};
+
+// Paylaşılan iz alanı; parçalar sırayla dağıtılır, alan dolarsa olaylar sayılıp atlanır
+struct TraceArena {
+    atomic_int next_chunk;        // Sonraki boş parça
+    int chunk_count;              // Parça sayısı
+    atomic_ulong dropped;         // Yer kalmadığı için atlanan olay sayısı
+    struct TraceChunk chunks[];
+};
 
-    // Kolon ve kirişler
-    printf("[Kat %d] Kolon ve kirişler yapılıyor...\n", floor+1);
-    random_delay(1.5, 2.5);                             // Rastgele gecikme
-    float material_cost2 = 15000.0f;                    // Malzeme maliyeti
-    float labor_cost2 = material_cost2 * 0.4;           // İşçilik maliyeti
-    add_cost(material_cost2, labor_cost2, "floor");     // Maliyeti ekle
+static const char *trace_path;              // --trace ile verilen dosya (NULL: iz kapalı)
+static struct TraceArena *trace_arena;      // Kayıt sürerken iz alanı
+static size_t trace_arena_size;             // İz alanının boyutu
+static uint64_t trace_epoch;                // Gerçek modda zaman sıfırı
+static atomic_uint trace_flow_ids;          // Kaynak devri akış kimlikleri
+static __thread struct TraceChunk *trace_chunk; // Bu thread'in parçası
+static __thread int32_t trace_pid, trace_tid;   // Önbelleğe alınmış süreç ve thread kimlikleri
 
-    // Duvarlar
-    printf("[Kat %d] Duvarlar örülüyor...\n", floor+1);
-    random_delay(1.0, 2.0);                             // Rastgele gecikme
-    float material_cost3 = 8000.0f;                     // Malzeme maliyeti
-    float labor_cost3 = material_cost3 * 0.4;           // İşçilik maliyeti
-    add_cost(material_cost3, labor_cost3, "floor");     // Maliyeti ekle
+static int graph_job_node(enum JobKind kind, int floor, int apartment);
 
-    // Koridor ve merdivenler
-    printf("[Kat %d] Koridor ve merdivenler yapılıyor...\n", floor+1);
-    random_delay(0.5, 1.0);                             // Rastgele gecikme
-    float material_cost4 = 5000.0f;                     // Malzeme maliyeti
-    float labor_cost4 = material_cost4 * 0.4;           // İşçilik maliyeti
-    add_cost(material_cost4, labor_cost4, "floor");     // Maliyeti ekle
+// fork sonrası çocuk süreç ebeveyninin parçasına yazmamalı: yeni parça ve kimlik alır
+static void trace_atfork_child(void) {
+    trace_chunk = NULL;
+    trace_pid = trace_tid = 0;
+}
 
-    printf(COLOR_YELLOW "=== KAT %d KABA İNŞAATI TAMAMLANDI ===\n\n" COLOR_RESET, floor+1);
+// İz zamanı: gerçek modda başlangıçtan beri geçen ns, sanal modda sanal saat
+static inline uint64_t trace_now(void) {
+    if (!trace_arena) return 0;
+    if (run_mode == MODE_VIRTUAL) return (uint64_t)(virtual_now * TRACE_NS_PER_DAY);
+    return monotonic_ns() - trace_epoch;
+}
 
-    // Bir sonraki katın inşaatına izin vermek için semafor sinyali gönder
-    if (floor < TOTAL_FLOORS - 1) {
-        printf("Kat %d: Bir sonraki kat (%d) için semafor sinyal veriliyor\n", floor+1, floor+2);
-        if (sem_post(floor_semaphore[floor+1]) == -1) {
-            perror("sem_post failed"); // Hata kontrolü
+// Olayı bu thread'in parçasına yazar; tid < 0 ise çağıran thread kullanılır
+static void trace_record(char phase, enum TraceWhat what, int kind, int index, int floor, int apartment,
+                         uint64_t ts, uint64_t dur, uint32_t id, int32_t tid) {
+    if (!trace_chunk || trace_chunk->used == TRACE_CHUNK_EVENTS) { // Parça doldu: yenisini al
+        int c = atomic_fetch_add_explicit(&trace_arena->next_chunk, 1, memory_order_relaxed);
+        if (c >= trace_arena->chunk_count) {
+            trace_chunk = NULL;
+            atomic_fetch_add_explicit(&trace_arena->dropped, 1, memory_order_relaxed);
+            return;
         }
-        usleep(1000); // 1 ms gecikme
+        trace_chunk = &trace_arena->chunks[c];
+    }
+    if (!trace_pid) {
+        trace_pid = getpid();
+        trace_tid = (int32_t)syscall(SYS_gettid);
+    }
+    struct TraceEvent *ev = &trace_chunk->events[trace_chunk->used++];
+    *ev = (struct TraceEvent){ ts, dur, trace_pid, tid < 0 ? trace_tid : tid, floor, apartment, id,
+                               phase, (uint8_t)what, (uint8_t)kind, (uint8_t)index };
+}
+
+// Sanal moddaki iş şeridi (gerçek modda -1: çağıran thread)
+static int32_t trace_lane(enum JobKind kind, int floor, int apartment) {
+    return run_mode == MODE_VIRTUAL ? graph_job_node(kind, floor, apartment) + 1 : -1;
+}
+
+// İş başlangıcı/bitişi; sanal modda şerit ilk açılışta adlandırılır
+void trace_job(enum JobKind kind, int floor, int apartment, int done) {
+    if (!trace_arena) return;
+    int32_t lane = trace_lane(kind, floor, apartment);
+    uint32_t id = (uint32_t)graph_job_node(kind, floor, apartment) + 1;
+    if (!done && lane >= 0) trace_record('M', TRACE_NAME, TRACE_NAME_LANE, kind, floor, apartment, 0, 0, 0, lane);
+    trace_record(done ? 'e' : 'b', TRACE_JOB, kind, 0, floor, apartment, trace_now(), 0, id, lane);
+}
+
+// Adım başlangıcı/bitişi. Gerçek modda havuzdaki adımlar askıya alınıp başka bir işçide
+// bitebildiğinden işin kimliğiyle eşzamansız aralıktır; kat süreçlerinin adımları thread satırındadır.
+void trace_step(enum JobKind kind, int floor, int apartment, int step_index, int done) {
+    if (!trace_arena) return;
+    if (run_mode != MODE_VIRTUAL && kind != JOB_FLOOR) {
+        trace_record(done ? 'e' : 'b', TRACE_STEP, kind, step_index, floor, apartment, trace_now(), 0,
+                     (uint32_t)graph_job_node(kind, floor, apartment) + 1, -1);
+        return;
+    }
+    trace_record(done ? 'E' : 'B', TRACE_STEP, kind, step_index, floor, apartment, trace_now(), 0, 0,
+                 trace_lane(kind, floor, apartment));
+}
+
+// start anından şimdiye süren aralık; flow 's' ise aralığın ortasına akışın kaynağı, 'f' ise
+// aralığın sonuna (bekleme bittiğinde) akışın hedefi eklenir
+void trace_span(enum TraceWhat what, int kind, int floor, int apartment, uint64_t start,
+                char flow, uint32_t flow_id, int32_t tid) {
+    if (!trace_arena) return;
+    uint64_t end = trace_now();
+    uint64_t dur = end > start ? end - start : 0;
+    trace_record('X', what, kind, 0, floor, apartment, start, dur, 0, tid);
+    if (flow) {
+        uint64_t at = flow == 's' ? start + dur / 2 : start + (dur > 0 ? dur - 1 : 0); // Aralığın içinde kalsın
+        trace_record(flow, what, kind, 0, floor, apartment, at, 0, flow_id, tid);
+    }
+}
+
+// start anından şimdiye süren eşzamansız aralık (askıdaki görevin beklemesi; id işin kimliği)
+void trace_async(enum TraceWhat what, int kind, int floor, int apartment, uint64_t start, uint32_t id) {
+    if (!trace_arena) return;
+    trace_record('b', what, kind, 0, floor, apartment, start, 0, id, -1);
+    trace_record('e', what, kind, 0, floor, apartment, trace_now(), 0, id, -1);
+}
+
+// Bu thread'i (ya da süreci) adlandırır
+void trace_name(enum TraceName name, int index) {
+    if (!trace_arena) return;
+    trace_record('M', TRACE_NAME, name, 0, index, -1, 0, 0, 0, -1);
+}
+
+// İz alanını ayırır: daire ve kat başına beklenen olay sayısı ile yazar başına yarım kalan parçalar kadar
+void trace_init(long unit_count) {
+    const struct JobProgram *apt = &job_programs[JOB_APARTMENT];
+    long per_apartment = 3 + 2L * apt->step_count;
+    for (int i = 0; i < apt->step_count; i++) {
+        if (apt->steps[i].resource != RES_NONE) per_apartment += 4; // Bekleme aralığı ve devir akışı
+    }
+    long per_floor = 3 + 2L * job_programs[JOB_FLOOR].step_count + 5; // İş, adımlar, bildirim ve süreç adı
+    long events = unit_count * per_apartment + (long)total_floors * per_floor + 256;
+    long writers = total_floors + (pool_workers > 64 ? pool_workers : 64) + 8;
+    long chunks = (events + TRACE_CHUNK_EVENTS - 1) / TRACE_CHUNK_EVENTS + writers;
+
+    trace_arena_size = sizeof(struct TraceArena) + chunks * sizeof(struct TraceChunk);
+    trace_arena = mmap(NULL, trace_arena_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_ANONYMOUS | MAP_POPULATE, -1, 0); // Kat süreçleri de yazar; sayfalar önceden hazır
+    if (trace_arena == MAP_FAILED) {
+        perror("mmap failed");
+        exit(EXIT_FAILURE);
     }
+    trace_arena->chunk_count = (int)chunks;
+    pthread_atfork(NULL, NULL, trace_atfork_child);
+    trace_epoch = monotonic_ns();
+    if (run_mode != MODE_VIRTUAL) trace_name(TRACE_NAME_MAIN, 0);
 }
 
-// Temel atma fonksiyonu
-void build_foundation() {
-    printf(COLOR_RED "\n=== TEMEL ATMA İŞLEMLERİ BAŞLADI ===\n" COLOR_RESET);
+// ---------------------------------------------------------------------------
+// İkili olay günlüğü (--event-log=DOSYA): her adım başlangıcı ve bitişi ile her add_cost
+// çağrısı sabit genişlikte bir kayıt olarak, yalnızca sona eklenen ve belleğe eşlenen bir
+// dosyaya yazılır. Yazarlar (thread'ler ve kat süreçleri) başlıktaki atomik imleçten blok
+// blok yer ayırır ve kendi bloklarını kilitsiz doldurur; dosya büyük parçalar halinde uzatılır.
+// Doldurulmadan kalan kayıtların türü 0'dır ve çözümleyici tarafından atlanır.
+// --analyze=DOSYA günlüğü eşleyip kat, kategori ve adım özetlerini çıkarır.
+// ---------------------------------------------------------------------------
+
+#define EVENT_LOG_MAGIC 0x31474f4c544e5645ULL // "EVNTLOG1"
+#define EVENT_LOG_VERSION 2
+#define EVENT_LOG_DATA 4096                     // Kayıtların dosyadaki başlangıcı (başlık sayfası)
+#define EVENT_LOG_RESERVE (1ULL << 38)          // Eşlenen adres aralığı (dosya bu sınıra kadar büyüyebilir)
+#define EVENT_LOG_GROW (1ULL << 21)             // Dosya bu kadar kayıtlık parçalarla uzatılır (64 MB)
+#define EVENT_BLOCK_RECORDS 256                 // Yazarın bir seferde ayırdığı kayıt sayısı
+
+// Kayıt türleri
+enum EventType {
+    EVENT_NONE,           // Ayrılmış ama yazılmamış kayıt
+    EVENT_STEP_START,     // Adım başladı
+    EVENT_STEP_END,       // Adım bitti; adımın maliyeti kayıttadır
+    EVENT_COST,           // Adıma bağlı olmayan maliyet (ekip günlükleri, kat bildirimleri, taşan tutarlar)
+};
 
-    printf("Zemin etüdü yapılıyor...\n");
-    random_delay(1.0, 2.0); // Rastgele gecikme
+// Sabit genişlikte olay kaydı (32 bayt)
+struct EventRecord {
+    uint64_t time;        // Zaman (ns; sanal modda 1 gün = 1 sn)
+    int32_t floor;        // Kat (-1: binaya ait)
+    int32_t apartment;    // Daire (-1: kata ait)
+    uint32_t replica;     // Monte Carlo kopyası (tek koşuda 0)
+    uint8_t type;         // enum EventType
+    uint8_t category;     // Maliyet kategorisi
+    uint8_t kind;         // İş türü (EVENT_COST kayıtlarında JOB_KIND_COUNT)
+    uint8_t step;         // Adım indeksi
+    int32_t material;     // Malzeme maliyeti (kuruş)
+    int32_t labor;        // İşçilik maliyeti (kuruş)
+};
 
-    printf("Temel kazısı başladı...\n");
-    random_delay(2.0, 3.0); // Rastgele gecikme
+// Dosyanın ilk sayfası
+struct EventLogHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t seed;
+    int32_t floors, apartments;
+    int32_t mode;                  // Kapanıştaki çalışma modu (zaman birimi için)
+    int32_t replicas;              // Kopya sayısı (tek koşuda 1)
+    _Atomic uint64_t reserved;     // Ayrılan kayıt sayısı
+    _Atomic uint64_t committed;    // Dosyada yeri olan kayıt sayısı
+    _Atomic uint64_t dropped;      // Adres aralığı dolduğu için atlanan kayıt
+    pthread_mutex_t grow_mutex;    // Dosyayı uzatan yazarları sıralar (süreçler arası)
+};
 
-    printf("Temel betonu dökülüyor...\n");
-    random_delay(1.5, 2.5); // Rastgele gecikme
+static const char *event_log_path;          // --event-log ile verilen dosya (NULL: kapalı)
+static struct EventLogHeader *event_log;    // Eşlenen dosyanın başlığı
+static struct EventRecord *event_records;   // Kayıt dizisi (başlık sayfasından sonra)
+static int event_log_fd = -1;               // Dosyayı uzatmak için açık tutulur (kat süreçlerine de geçer)
+static uint64_t event_log_epoch;            // Gerçek modda zaman sıfırı
+static __thread struct EventRecord *event_block; // Bu yazarın bloğundaki sıradaki kayıt
+static __thread uint32_t event_block_left;  // Bloktaki boş kayıt sayısı
+static __thread uint32_t event_replica;     // Bu thread'in koştuğu kopya
+static __thread int event_muted;            // Karşılaştırma ve eniyileme koşuları günlüğe yazmaz
 
-    printf("Temel kürleniyor...\n");
-    random_delay(3.0, 5.0); // Rastgele gecikme
+// fork sonrası çocuk ebeveyninin bloğuna yazmamalı: ilk kayıtta kendi bloğunu ayırır
+static void event_log_atfork_child(void) {
+    event_block = NULL;
+    event_block_left = 0;
+}
 
-    // İlk katın inşaatına izin vermek için semafor sinyali gönder
-    printf("Temel: İlk kat için semafor sinyal veriliyor\n");
-    if (sem_post(floor_semaphore[0]) == -1) {
-        perror("sem_post failed"); // Hata kontrolü
+// Kayıt sayısı end'e kadar dosyanın içinde kalsın
+static void event_log_grow(uint64_t end) {
+    pthread_mutex_lock(&event_log->grow_mutex);
+    uint64_t committed = atomic_load(&event_log->committed);
+    if (committed < end) {
+        committed = (end + EVENT_LOG_GROW - 1) / EVENT_LOG_GROW * EVENT_LOG_GROW;
+        if (ftruncate(event_log_fd, EVENT_LOG_DATA + committed * sizeof(struct EventRecord)) != 0) {
+            perror("olay günlüğü büyütülemedi");
+            exit(EXIT_FAILURE);
+        }
+        atomic_store(&event_log->committed, committed);
     }
+    pthread_mutex_unlock(&event_log->grow_mutex);
+}
 
-    float material_cost = 150000.0f;                    // Malzeme maliyeti
-    float labor_cost = material_cost * 0.4;             // İşçilik maliyeti
-    add_cost(material_cost, labor_cost, "foundation");  // Maliyeti ekle
-    printf(COLOR_RED "=== TEMEL ATMA İŞLEMLERİ TAMAMLANDI ===\n\n" COLOR_RESET);
+// Yazarın bloğundan sıradaki kaydı verir; blok bittiyse yenisini ayırır
+static struct EventRecord *event_log_slot(void) {
+    if (event_block_left == 0) {
+        uint64_t first = atomic_fetch_add_explicit(&event_log->reserved, EVENT_BLOCK_RECORDS, memory_order_relaxed);
+        uint64_t end = first + EVENT_BLOCK_RECORDS;
+        if (end > (EVENT_LOG_RESERVE - EVENT_LOG_DATA) / sizeof(struct EventRecord)) {
+            atomic_fetch_add_explicit(&event_log->dropped, 1, memory_order_relaxed);
+            return NULL;
+        }
+        if (end > atomic_load_explicit(&event_log->committed, memory_order_acquire)) event_log_grow(end);
+        event_block = &event_records[first];
+        event_block_left = EVENT_BLOCK_RECORDS;
+    }
+    event_block_left--;
+    return event_block++;
 }
 
-// Maliyet özetini yazdıran fonksiyon
-void print_cost_summary() {
-    printf(COLOR_CYAN "\n=== MALİYET ÖZETİ ===\n" COLOR_RESET);
-    printf("Kategori                | Malzeme Maliyeti | İşçilik Maliyeti | Toplam\n");
-    printf("------------------------|------------------|------------------|------------\n");
-    // Her kategori için malzeme, işçilik ve toplam maliyetleri yazdır
-    printf("Temel Atma             | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->foundation_material_cost, shared_data->foundation_labor_cost,
-           shared_data->foundation_material_cost + shared_data->foundation_labor_cost);
-    printf("Kat İnşaatı            | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->floor_material_cost, shared_data->floor_labor_cost,
-           shared_data->floor_material_cost + shared_data->floor_labor_cost);
-    printf("Elektrik Tesisatı      | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->electrical_material_cost, shared_data->electrical_labor_cost,
-           shared_data->electrical_material_cost + shared_data->electrical_labor_cost);
-    printf("Sıhhi Tesisat          | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->plumbing_material_cost, shared_data->plumbing_labor_cost,
-           shared_data->plumbing_material_cost + shared_data->plumbing_labor_cost);
-    printf("Boya                   | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->painting_material_cost, shared_data->painting_labor_cost,
-           shared_data->painting_material_cost + shared_data->painting_labor_cost);
-    printf("Zemin Kaplama          | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->flooring_material_cost, shared_data->flooring_labor_cost,
-           shared_data->flooring_material_cost + shared_data->flooring_labor_cost);
-    printf("Pencere Montajı        | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->window_material_cost, shared_data->window_labor_cost,
-           shared_data->window_material_cost + shared_data->window_labor_cost);
-    printf("Mutfak Dolabı          | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->kitchen_material_cost, shared_data->kitchen_labor_cost,
-           shared_data->kitchen_material_cost + shared_data->kitchen_labor_cost);
-    printf("Banyo Montajı          | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->bathroom_material_cost, shared_data->bathroom_labor_cost,
-           shared_data->bathroom_material_cost + shared_data->bathroom_labor_cost);
-    printf("Son Temizlik           | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->cleaning_material_cost, shared_data->cleaning_labor_cost,
-           shared_data->cleaning_material_cost + shared_data->cleaning_labor_cost);
-    printf("Çatı ve Ortak Alanlar  | %.2f TL         | %.2f TL         | %.2f TL\n",
-           shared_data->roof_material_cost, shared_data->roof_labor_cost,
-           shared_data->roof_material_cost + shared_data->roof_labor_cost);
-    printf("------------------------|------------------|------------------|------------\n");
+// Tutarın kayda sığan parçası (32 bit kuruş)
+static inline int32_t event_cost_part(int64_t kurus) {
+    return kurus > INT32_MAX ? INT32_MAX : kurus < INT32_MIN ? INT32_MIN : (int32_t)kurus;
+}
 
-    // Toplam malzeme ve işçilik maliyetlerini hesaplama
-    float total_material = shared_data->foundation_material_cost + shared_data->floor_material_cost +
-                          shared_data->electrical_material_cost + shared_data->plumbing_material_cost +
-                          shared_data->painting_material_cost + shared_data->flooring_material_cost +
-                          shared_data->window_material_cost + shared_data->kitchen_material_cost +
-                          shared_data->bathroom_material_cost + shared_data->cleaning_material_cost +
-                          shared_data->roof_material_cost;
-    float total_labor = shared_data->foundation_labor_cost + shared_data->floor_labor_cost +
-                        shared_data->electrical_labor_cost + shared_data->plumbing_labor_cost +
-                        shared_data->painting_labor_cost + shared_data->flooring_labor_cost +
-                        shared_data->window_labor_cost + shared_data->kitchen_labor_cost +
-                        shared_data->bathroom_labor_cost + shared_data->cleaning_labor_cost +
-                        shared_data->roof_labor_cost;
-    printf("TOPLAM                 | %.2f TL         | %.2f TL         | %.2f TL\n",
-           total_material, total_labor, shared_data->total_cost);
+// Bir kaydı günlüğe yazar. 32 bite sığmayan tutarın (büyük ekip günlükleri) kalanı aynı kat ve
+// kategoride EVENT_COST kayıtlarıyla yazılır; çözümleyici toplamı kuruşu kuruşuna bulur.
+static void event_log_emit(enum EventType type, int kind, int step, int floor, int apartment,
+                           enum CostCategory category, int64_t material, int64_t labor) {
+    if (!event_log || event_muted) return;
+    uint64_t now = run_mode == MODE_VIRTUAL ? (uint64_t)(virtual_now * TRACE_NS_PER_DAY) : monotonic_ns() - event_log_epoch;
+    do {
+        struct EventRecord *rec = event_log_slot();
+        if (!rec) return;
+        int32_t m = event_cost_part(material), l = event_cost_part(labor);
+        *rec = (struct EventRecord){ now, floor, apartment, event_replica, (uint8_t)type, (uint8_t)category,
+                                     (uint8_t)kind, (uint8_t)step, m, l };
+        material -= m;
+        labor -= l;
+        type = EVENT_COST; // Kalan parçalar adım sayılmaz
+        kind = JOB_KIND_COUNT;
+        step = 0;
+    } while (material != 0 || labor != 0);
 }
 
-int main() {
-    srand(time(NULL)); // Rastgele sayı üreticisini başlat
+// Adım başlangıcı ya da bitişi (bitişte adımın maliyetiyle, kuruş)
+static void event_log_step(enum JobKind kind, int floor, int apartment, int step_index, int done,
+                           int64_t material, int64_t labor) {
+    if (!event_log) return;
+    event_log_emit(done ? EVENT_STEP_END : EVENT_STEP_START, kind, step_index, floor, apartment,
+                   job_programs[kind].steps[step_index].category, material, labor);
+}
 
-    // Paylaşılan bellek oluştur
-    int shm_fd = shm_open("/construction_shm", O_CREAT | O_RDWR, 0666); // Paylaşılan bellek dosyası oluştur
-    if (shm_fd == -1) {
-        perror("shm_open failed"); // Hata kontrolü
+// Günlük dosyasını oluşturur ve eşler; kat süreçleri fork'tan önce açılmalı
+void event_log_open(const char *path) {
+    event_log_fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (event_log_fd < 0 || ftruncate(event_log_fd, EVENT_LOG_DATA) != 0) {
+        perror("olay günlüğü açılamadı");
         exit(EXIT_FAILURE);
     }
-
-    if (ftruncate(shm_fd, sizeof(struct SharedData)) == -1) { // Bellek boyutunu ayarla
-        perror("ftruncate failed");
+    void *base = mmap(NULL, EVENT_LOG_RESERVE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, event_log_fd, 0);
+    if (base == MAP_FAILED) {
+        perror("mmap failed");
         exit(EXIT_FAILURE);
     }
+    event_log = base;
+    event_records = (struct EventRecord *)((char *)base + EVENT_LOG_DATA);
+    event_log->magic = EVENT_LOG_MAGIC;
+    event_log->version = EVENT_LOG_VERSION;
+    event_log->record_size = sizeof(struct EventRecord);
+    event_log->floors = total_floors;
+    event_log->apartments = apartments_per_floor;
+    event_log->replicas = 1;
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&event_log->grow_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    pthread_atfork(NULL, NULL, event_log_atfork_child);
+    event_log_epoch = monotonic_ns();
+}
 
-    // Paylaşılan belleği eşle
-    shared_data = mmap(NULL, sizeof(struct SharedData), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-    if (shared_data == MAP_FAILED) {
-        perror("mmap failed");
+// Başlığı tamamlar, dosyayı ayrılan kayıtlara kırpar ve eşlemeyi bırakır
+void event_log_close(void) {
+    uint64_t records = atomic_load(&event_log->reserved);
+    uint64_t committed = atomic_load(&event_log->committed);
+    if (records > committed) records = committed; // Yer bulamayan son bloklar
+    unsigned long dropped = (unsigned long)atomic_load(&event_log->dropped);
+    event_log->seed = run_seed;
+    event_log->mode = run_mode;
+    pthread_mutex_destroy(&event_log->grow_mutex);
+    munmap(event_log, EVENT_LOG_RESERVE);
+    event_log = NULL;
+    if (ftruncate(event_log_fd, EVENT_LOG_DATA + records * sizeof(struct EventRecord)) != 0) {
+        perror("olay günlüğü kırpılamadı");
         exit(EXIT_FAILURE);
     }
+    close(event_log_fd);
+    event_log_fd = -1;
+    printf("Olay günlüğü: %s (%llu kayıt yeri, %.1f MB", event_log_path, (unsigned long long)records,
+           (EVENT_LOG_DATA + records * sizeof(struct EventRecord)) / 1e6);
+    if (dropped > 0) printf(", yer kalmadığı için %lu blok atlandı", dropped);
+    printf(")\n");
+}
 
-    // Paylaşılan bellek değişkenlerini sıfırla
-    shared_data->total_cost = 0.0f;
-    shared_data->foundation_material_cost = 0.0f;
-    shared_data->foundation_labor_cost = 0.0f;
-    shared_data->floor_material_cost = 0.0f;
-    shared_data->floor_labor_cost = 0.0f;
-    shared_data->electrical_material_cost = 0.0f;
-    shared_data->electrical_labor_cost = 0.0f;
-    shared_data->plumbing_material_cost = 0.0f;
-    shared_data->plumbing_labor_cost = 0.0f;
-    shared_data->painting_material_cost = 0.0f;
-    shared_data->painting_labor_cost = 0.0f;
-    shared_data->flooring_material_cost = 0.0f;
-    shared_data->flooring_labor_cost = 0.0f;
-    shared_data->window_material_cost = 0.0f;
-    shared_data->window_labor_cost = 0.0f;
-    shared_data->kitchen_material_cost = 0.0f;
-    shared_data->kitchen_labor_cost = 0.0f;
-    shared_data->bathroom_material_cost = 0.0f;
-    shared_data->bathroom_labor_cost = 0.0f;
-    shared_data->cleaning_material_cost = 0.0f;
-    shared_data->cleaning_labor_cost = 0.0f;
-    shared_data->roof_material_cost = 0.0f;
-    shared_data->roof_labor_cost = 0.0f;
-
-    // Mutex'i paylaşılan bellekte başlat
-    pthread_mutexattr_t mutex_attr; //Mutex özelliklerini tanımlamak için bir mutex öznitelik nesnesi oluştur
-    pthread_mutexattr_init(&mutex_attr);
-    pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED); // Mutex'in süreçler arasında paylaşılması sağlanır
-                                                                       //PTHREAD_PROCESS_SHARED ayarı, mutex'in yalnızca aynı süreç içindeki iş parçacıkları
-                                                                       //tarafından değil, farklı süreçler tarafından da kullanılabileceğini belirtir.
-    pthread_mutex_init(&shared_data->cost_mutex, &mutex_attr);         //Paylaşılan bellekteki mutex'i başlat:
-    pthread_mutexattr_destroy(&mutex_attr);                            // Mutex öznitelik nesnesini yok et:
+// ---------------------------------------------------------------------------
+// Asenkron günlük: üreticiler paylaşılan bellekteki halkaya sabit boyutlu ikili kayıt
+// yazar, metne çevirme ve terminale yazma yalnızca ana süreçteki boşaltıcı thread'de yapılır.
+// ---------------------------------------------------------------------------
 
-    // Mevcut semaforları temizle
-    char sem_name[32];
-    for (int i = 0; i < TOTAL_FLOORS; i++) {
-        snprintf(sem_name, sizeof(sem_name), "/floor_sem_%d", i);
-        sem_unlink(sem_name); // Eski semaforları kaldır
-    }
-
-    // Adlandırılmış semaforları başlat
-    for (int i = 0; i < TOTAL_FLOORS; i++) {
-        snprintf(sem_name, sizeof(sem_name), "/floor_sem_%d", i);
-        floor_semaphore[i] = sem_open(sem_name, O_CREAT, 0644, 0); // Yeni semafor oluştur
-        if (floor_semaphore[i] == SEM_FAILED) {
-            perror("sem_open failed");
-            floor_semaphore[i] = sem_open(sem_name, 0); //Hata durumunda tekrar dene
-            if (floor_semaphore[i] == SEM_FAILED) {
-                perror("sem_open retry failed");
-                exit(EXIT_FAILURE);
-            }
+// Sabit mesajların metinleri ve seviyeleri (argümanlar kayıttaki floor/apartment alanlarıdır)
+enum LogMessage {
+    MSG_FOUNDATION_SIGNAL,     // Temel bitti, ilk kat başlayabilir
+    MSG_FLOOR_SIGNAL,          // Kat süreci bittiğini bildiriyor
+    MSG_FLOOR_WAIT,            // Ana süreç katın bildirimini bekliyor
+    MSG_FLOOR_RECEIVED,        // Ana süreç katın bildirimini aldı
+    MSG_FLOOR_CRASH,           // Kat süreci bildirmeden öldü, kat yeniden kuyrukta
+    MSG_INTERIOR_START,        // Tüm dairelerin iç dizaynı başladı
+    MSG_INTERIOR_FLOOR_START,  // Bir katın iç dizaynı başladı
+    MSG_INTERIOR_FLOOR_DONE,   // Bir katın iç dizaynı bitti
+    MSG_INTERIOR_DONE,         // Tüm dairelerin iç dizaynı bitti
+    MSG_POOL_SIZE,             // İş havuzunun işçi sayısı
+    MSG_COUNT
+};
+
+static const struct {
+    enum LogLevel level;  // Mesajın seviyesi
+    const char *format;   // printf biçimi (en fazla iki %d)
+} log_messages[MSG_COUNT] = {
+    [MSG_FOUNDATION_SIGNAL]    = { LOG_LEVEL_TASK,  "Temel: Tamamlandı, ilk kat başlayabilir\n" },
+    [MSG_FLOOR_SIGNAL]         = { LOG_LEVEL_TASK,  "Kat %d: Tamamlandı, ana sürece bildiriliyor\n" },
+    [MSG_FLOOR_WAIT]           = { LOG_LEVEL_TASK,  "Ana süreç: Kat %d bildirimi bekleniyor\n" },
+    [MSG_FLOOR_RECEIVED]       = { LOG_LEVEL_TASK,  "Ana süreç: Kat %d bildirimi alındı (%d TL)\n" },
+    [MSG_FLOOR_CRASH]          = { LOG_LEVEL_PHASE, COLOR_RED "Ana süreç: Kat %d süreci bildirmeden öldü, kat yeniden kuyruğa alındı (%d. deneme)\n" COLOR_RESET },
+    [MSG_INTERIOR_START]       = { LOG_LEVEL_PHASE, COLOR_CYAN "\n=== TÜM DAİRELERİN İÇ DİZAYN İŞLEMLERİ BAŞLADI ===\n" COLOR_RESET },
+    [MSG_INTERIOR_FLOOR_START] = { LOG_LEVEL_PHASE, COLOR_CYAN "=== KAT %d İÇ DİZAYN İŞLEMLERİ BAŞLADI ===\n" COLOR_RESET },
+    [MSG_INTERIOR_FLOOR_DONE]  = { LOG_LEVEL_PHASE, COLOR_CYAN "=== KAT %d İÇ DİZAYN İŞLEMLERİ TAMAMLANDI ===\n\n" COLOR_RESET },
+    [MSG_INTERIOR_DONE]        = { LOG_LEVEL_PHASE, COLOR_CYAN "=== TÜM DAİRELERİN İÇ DİZAYN İŞLEMLERİ TAMAMLANDI ===\n\n" COLOR_RESET },
+    [MSG_POOL_SIZE]            = { LOG_LEVEL_PHASE, "İş havuzu: %d işçi thread\n" },
+};
+
+// Verilen seviyedeki kayıtların yazılıp yazılmayacağını döndürür
+static inline int log_enabled(enum LogLevel level) {
+    return level <= log_level;
+}
+
+// Kaydı halkaya ekler; halka doluysa boşaltıcı yer açana kadar bekler (kayıt kaybolmaz)
+void log_push(struct LogRecord *rec) {
+    struct LogRing *ring = &shared_data->log;
+    uint64_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    struct LogRecord *cell;
+    for (;;) {
+        cell = &ring->cells[pos & (LOG_RING_SIZE - 1)];
+        uint64_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) { // Hücre boş: konumu sahiplenmeyi dene
+            if (atomic_compare_exchange_weak_explicit(&ring->tail, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) break;
+        } else if (diff < 0) { // Halka dolu: boşaltıcıya işlemci bırak
+            atomic_fetch_add_explicit(&ring->full_waits, 1, memory_order_relaxed);
+            sched_yield();
+            pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        } else { // Başka yazar bu konumu aldı
+            pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
         }
     }
+    rec->pid = log_pid;
+    rec->time = run_mode == MODE_VIRTUAL ? virtual_now : -1.0;
+    cell->type = rec->type;
+    cell->kind = rec->kind;
+    cell->index = rec->index;
+    cell->pid = rec->pid;
+    cell->floor = rec->floor;
+    cell->apartment = rec->apartment;
+    cell->time = rec->time;
+    cell->a = rec->a;
+    cell->b = rec->b;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release); // Kaydı okuyucuya yayınla
+}
 
-    // Diğer senkronizasyon nesnelerini başlat
-    sem_init(&elevator_sem, 0, 1); // Asansör semaforu (tek kullanıcı)
-    sem_init(&stairs_sem, 0, 2);   // Merdiven semaforu (2 kullanıcı)
+// Adım başlangıç/bitiş kaydı
+void log_step(enum JobKind kind, int floor, int apartment, int step_index, int done) {
+    trace_step(kind, floor, apartment, step_index, done); // İz seviyeden bağımsızdır
+    if (!done) event_log_step(kind, floor, apartment, step_index, 0, 0, 0); // Bitiş maliyetle birlikte yazılır
+    if (!log_enabled(LOG_LEVEL_TASK)) return;
+    struct LogRecord rec = { .type = done ? LOG_STEP_DONE : LOG_STEP_START, .kind = kind,
+                             .index = step_index, .floor = floor, .apartment = apartment };
+    log_push(&rec);
+}
 
-    // Simülasyon başlangıç mesajı
-    printf(COLOR_GREEN "\n10 KATLI APARTMAN İNŞAAT SIMÜLASYONU BAŞLIYOR\n" COLOR_RESET);
-    printf("Toplam süre: %d gün\n", TOTAL_DAYS);
-    printf("====================================\n");
+// İş başlığı kaydı (daire başlıkları görev seviyesindedir)
+void log_job(enum JobKind kind, int floor, int apartment, int done) {
+    trace_job(kind, floor, apartment, done);
+    if (!log_enabled(kind == JOB_APARTMENT ? LOG_LEVEL_TASK : LOG_LEVEL_PHASE)) return;
+    struct LogRecord rec = { .type = done ? LOG_JOB_DONE : LOG_JOB_START, .kind = kind,
+                             .floor = floor, .apartment = apartment };
+    log_push(&rec);
+}
 
-    build_foundation(); // Temel atma işlemini gerçekleştir
+// Maliyet kaydı
+void log_cost(enum CostCategory category, double material_cost, double labor_cost) {
+    if (!log_enabled(LOG_LEVEL_TASK)) return;
+    struct LogRecord rec = { .type = LOG_COST, .index = category, .a = material_cost, .b = labor_cost };
+    log_push(&rec);
+}
 
-    // Her kat için kaba inşaat işlemi
-    for (int floor = 0; floor < TOTAL_FLOORS; floor++) {
-        if (floor > 0) {
-            printf("Ana süreç: Kat %d için semafor bekleniyor\n", floor+1);
-            if (sem_wait(floor_semaphore[floor]) == -1) { // Bir önceki katın tamamlanmasını bekle
-                perror("sem_wait failed");
-                exit(EXIT_FAILURE);
-            }
-        }
+// Sabit metinli mesaj kaydı
+void log_message(enum LogMessage msg, int arg1, int arg2) {
+    if (!log_enabled(log_messages[msg].level)) return;
+    struct LogRecord rec = { .type = LOG_MSG, .kind = msg, .floor = arg1, .apartment = arg2 };
+    log_push(&rec);
+}
 
-        print_day_info(); // Gün bilgisini yazdır
+// İş başlangıç/bitiş başlığını biçimlendirir
+static void format_job_banner(FILE *out, const struct LogRecord *r, int done) {
+    int floor = r->floor, apartment = r->apartment;
+    switch (r->kind) {
+    case JOB_FOUNDATION:
+        if (!done) fprintf(out, COLOR_RED "\n=== TEMEL ATMA İŞLEMLERİ BAŞLADI ===\n" COLOR_RESET);
+        else       fprintf(out, COLOR_RED "=== TEMEL ATMA İŞLEMLERİ TAMAMLANDI ===\n\n" COLOR_RESET);
+        break;
+    case JOB_FLOOR:
+        if (!done) fprintf(out, "\n" COLOR_YELLOW "=== KAT %d KABA İNŞAATI BAŞLADI (PID: %d) ===\n" COLOR_RESET, floor+1, r->pid);
+        else       fprintf(out, COLOR_YELLOW "=== KAT %d KABA İNŞAATI TAMAMLANDI ===\n\n" COLOR_RESET, floor+1);
+        break;
+    case JOB_APARTMENT:
+        if (!done) fprintf(out, "\n" COLOR_CYAN "--- Kat %d Daire %d iç dizayn başladı ---\n" COLOR_RESET, floor+1, apartment+1);
+        else       fprintf(out, COLOR_CYAN "--- Kat %d Daire %d iç dizayn tamamlandı ---\n\n" COLOR_RESET, floor+1, apartment+1);
+        break;
+    case JOB_ROOF:
+        if (!done) fprintf(out, COLOR_RED "\n=== ÇATI KATI İNŞAATI BAŞLADI ===\n" COLOR_RESET);
+        else       fprintf(out, COLOR_RED "=== ÇATI KATI TAMAMLANDI ===\n\n" COLOR_RESET);
+        break;
+    default: // Çatı iskeletinin ayrı başlığı yoktur
+        break;
+    }
+}
 
-        pid_t pid = fork();             // Yeni süreç oluştur
-        if (pid == 0) {                 // Çocuk süreç
-            floor_construction(floor);  // Kat inşaatını gerçekleştir
-            exit(0);                    // Çocuk süreci sonlandır
-        } else if (pid > 0) {           // Ana süreç
-            waitpid(pid, NULL, 0);      // Çocuk sürecin tamamlanmasını bekle
-        } else {
-            perror("fork hatası");      // Hata kontrolü
-            exit(EXIT_FAILURE);
-        }
+// Adım mesajını iş türüne uygun önekle ([Kat 1 Daire 2], [Kat 3], [Çatı]) biçimlendirir
+static void format_step(FILE *out, const struct LogRecord *r, int done) {
+    const struct TaskStep *step = &job_programs[r->kind].steps[r->index];
+    const char *msg = done ? step->done_msg : step->start_msg;
+    if (!msg) return; // Bitiş mesajı olmayan adım
 
-        // Son katın kaba inşaatından sonra çatı iskeleti yapımı
-        if (floor == TOTAL_FLOORS - 1) {
-            print_day_info();
-            roof_skeleton(); // Çatı iskeletini oluştur
-        }
+    char prefix[48] = "";
+    if (r->kind == JOB_APARTMENT) snprintf(prefix, sizeof(prefix), "[Kat %d Daire %d] ", r->floor+1, r->apartment+1);
+    else if (r->kind == JOB_FLOOR) snprintf(prefix, sizeof(prefix), "[Kat %d] ", r->floor+1);
+    else if (r->kind == JOB_ROOF_SKELETON) snprintf(prefix, sizeof(prefix), "[Çatı] ");
+
+    char clock[32] = "";
+    if (r->time >= 0.0) snprintf(clock, sizeof(clock), "<%7.2f. gün> ", r->time); // Sanal zaman damgası
+
+    if (step->color) fprintf(out, "%s%s%s%s" COLOR_RESET "\n", step->color, clock, prefix, msg);
+    else             fprintf(out, "%s%s%s\n", clock, prefix, msg);
+}
+
+// Tek bir kaydı mevcut COLOR_* kodlarıyla metne çevirir
+static void log_format(FILE *out, const struct LogRecord *r) {
+    switch (r->type) {
+    case LOG_STEP_START: format_step(out, r, 0); break;
+    case LOG_STEP_DONE:  format_step(out, r, 1); break;
+    case LOG_JOB_START:  format_job_banner(out, r, 0); break;
+    case LOG_JOB_DONE:   format_job_banner(out, r, 1); break;
+    case LOG_COST:
+        fprintf(out, "Kategori: %s, Malzeme maliyeti: %.2f TL, İşçilik maliyeti: %.2f TL\n",
+                category_names[r->index], r->a, r->b);
+        break;
+    case LOG_DAY:
+        fprintf(out, COLOR_CYAN "\n=== GÜN %d === (Toplam Maliyet: %.2f TL)\n" COLOR_RESET, r->floor, r->a);
+        break;
+    case LOG_MSG:
+        fprintf(out, log_messages[r->kind].format, r->floor, r->apartment);
+        break;
     }
+}
 
-    // Tüm dairelerin iç dizayn işlemleri
-    printf(COLOR_CYAN "\n=== TÜM DAİRELERİN İÇ DİZAYN İŞLEMLERİ BAŞLADI ===\n" COLOR_RESET);
-    for (int floor = 0; floor < TOTAL_FLOORS; floor++) {
-        print_day_info();
-        printf(COLOR_CYAN "=== KAT %d İÇ DİZAYN İŞLEMLERİ BAŞLADI ===\n" COLOR_RESET, floor+1);
+// Halkada bekleyen tüm kayıtları biçimlendirir; işlenen kayıt sayısını döndürür
+static unsigned long log_drain(FILE *out) {
+    struct LogRing *ring = &shared_data->log;
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned long drained = 0;
+    for (;;) {
+        struct LogRecord *cell = &ring->cells[head & (LOG_RING_SIZE - 1)];
+        if (atomic_load_explicit(&cell->seq, memory_order_acquire) != head + 1) break; // Henüz yayınlanmamış
+        log_format(out, cell);
+        atomic_store_explicit(&cell->seq, head + LOG_RING_SIZE, memory_order_release); // Hücreyi yazarlara geri ver
+        head++;
+        drained++;
+    }
+    atomic_store_explicit(&ring->head, head, memory_order_relaxed);
+    return drained;
+}
 
-        pthread_t threads[APARTMENTS_PER_FLOOR]; // Her daire için thread dizisi
-        for (int i = 0; i < APARTMENTS_PER_FLOOR; i++) {
-            int* args = malloc(2 * sizeof(int)); // Kat ve daire numarası için dinamik bellek tahsisi
-            args[0] = floor;
-            args[1] = i;
-            pthread_create(&threads[i], NULL, apartment_construction, args); // Thread oluştur
+// Boşaltıcı thread: kayıtları toplu halde biçimlendirir, halka boşalınca çıktıyı bir kerede yazar
+static void *log_drainer_main(void *arg) {
+    (void)arg;
+    long idle_ns = 20000; // Boşta bekleme süresi (20 µs'den 2 ms'ye kadar büyür)
+    for (;;) {
+        int stopping = atomic_load(&log_stop);
+        if (log_drain(log_out) > 0) {
+            idle_ns = 20000;
+            continue;
         }
+        fflush(log_out);               // Toplu yazma: terminale yalnızca halka boşken yazılır
+        if (stopping) break;           // Durma isteğinden sonra halka boşaldı
+        struct timespec ts = { 0, idle_ns };
+        nanosleep(&ts, NULL);
+        if (idle_ns < 2000000) idle_ns *= 2;
+    }
+    return NULL;
+}
+
+// fork sonrası çocuğun kayıtları kendi PID'ini taşımalı
+static void log_atfork_child(void) {
+    log_pid = getpid();
+}
+
+// Günlük halkasını hazırlar ve boşaltıcı thread'i başlatır
+void log_init(FILE *out) {
+    static int atfork_registered;
+    if (!atfork_registered) {
+        pthread_atfork(NULL, NULL, log_atfork_child);
+        atfork_registered = 1;
+    }
+    log_pid = getpid();
+    struct LogRing *ring = &shared_data->log;
+    for (uint64_t i = 0; i < LOG_RING_SIZE; i++) atomic_store(&ring->cells[i].seq, i);
+    atomic_store(&ring->head, 0);
+    atomic_store(&ring->tail, 0);
+    atomic_store(&ring->full_waits, 0);
+    log_out = out;
+    atomic_store(&log_stop, 0);
+    static char buffer[1 << 16];
+    if (out == stdout) setvbuf(stdout, buffer, _IOFBF, sizeof(buffer)); // Satır satır değil, toplu yaz
+    pthread_create(&log_drainer, NULL, log_drainer_main, NULL);
+    log_drainer_running = 1;
+}
+
+// Boşaltıcıyı durdurur; dönmeden önce halkadaki tüm kayıtlar yazılmış olur
+void log_shutdown(void) {
+    if (!log_drainer_running) return;
+    atomic_store(&log_stop, 1);
+    pthread_join(log_drainer, NULL);
+    log_drainer_running = 0;
+}
+
+// Malzeme ve işçilik maliyetlerini (kuruş) yazarın kendi dilimine kaydeder; item >= 0 ise
+// fiyat kaleminin tüketilen miktarı da kaydedilir
+static void ledger_add(int64_t material_cost, int64_t labor_cost, enum CostCategory category, int item, double quantity) {
+    if (cost_shard < 0) { // İlk maliyet kaydında bu yazar için dilim al
+        cost_shard = cost_shard_claim();
+        pthread_setspecific(cost_shard_key, &cost_shard); // Thread bitince dilim geri verilsin
+    }
+
+    if (cost_shard < COST_SHARDS) { // Kendi dilimi: kilit gerekmez
+        struct CostShard *shard = &shared_data->shards[cost_shard];
+        shard_add_kurus(&shard->material[category], material_cost);
+        shard_add_kurus(&shard->labor[category], labor_cost);
+        if (item >= 0) shard_add(&shard->quantity[item], quantity);
+    } else {                        // Dilimler tükendi: taşma dilimi kilitle paylaşılır
+        pthread_mutex_lock(&shared_data->cost_mutex);
+        shard_add_kurus(&shared_data->overflow.material[category], material_cost);
+        shard_add_kurus(&shared_data->overflow.labor[category], labor_cost);
+        if (item >= 0) shard_add(&shared_data->overflow.quantity[item], quantity);
+        pthread_mutex_unlock(&shared_data->cost_mutex);
+    }
+}
 
-        for (int i = 0; i < APARTMENTS_PER_FLOOR; i++) {
-            pthread_join(threads[i], NULL); // Thread'lerin tamamlanmasını bekle
+// Maliyet ekleme fonksiyonu: maliyeti deftere, günlüğe ve olay günlüğüne yazar
+void add_cost(double material_cost, double labor_cost, enum CostCategory category) {
+    ledger_add(to_kurus(material_cost), to_kurus(labor_cost), category, -1, 0.0);
+    log_cost(category, material_cost, labor_cost); // Maliyet güncellemesini günlüğe yaz (kilit dışında)
+    event_log_emit(EVENT_COST, JOB_KIND_COUNT, 0, -1, -1, category, to_kurus(material_cost), to_kurus(labor_cost));
+}
+
+// Tüm dilimlerin kategori başına kuruş toplamları
+void cost_totals_kurus(int64_t *material, int64_t *labor) {
+    memset(material, 0, CAT_COUNT * sizeof(int64_t));
+    memset(labor, 0, CAT_COUNT * sizeof(int64_t));
+    for (int i = 0; i <= COST_SHARDS; i++) {
+        const struct CostShard *shard = i < COST_SHARDS ? &shared_data->shards[i] : &shared_data->overflow;
+        for (int c = 0; c < CAT_COUNT; c++) {
+            material[c] += atomic_load_explicit(&shard->material[c], memory_order_relaxed);
+            labor[c] += atomic_load_explicit(&shard->labor[c], memory_order_relaxed);
         }
+    }
+}
 
-        printf(COLOR_CYAN "=== KAT %d İÇ DİZAYN İŞLEMLERİ TAMAMLANDI ===\n\n" COLOR_RESET, floor+1);
+// Tüm dilimleri toplayarak güncel maliyetleri hesaplayan fonksiyon
+void cost_totals(struct CostTotals *out) {
+    int64_t material[CAT_COUNT], labor[CAT_COUNT], total = 0;
+    cost_totals_kurus(material, labor);
+    for (int c = 0; c < CAT_COUNT; c++) {
+        out->material[c] = material[c] / 100.0;
+        out->labor[c] = labor[c] / 100.0;
+        total += material[c] + labor[c];
     }
-    printf(COLOR_CYAN "=== TÜM DAİRELERİN İÇ DİZAYN İŞLEMLERİ TAMAMLANDI ===\n\n" COLOR_RESET);
+    out->total = total / 100.0;
+}
 
-    // Çatı katı ve ortak alanlar
-    print_day_info();
-    printf(COLOR_RED "\n=== ÇATI KATI İNŞAATI BAŞLADI ===\n" COLOR_RESET);
-    printf("Çatı yapımı devam ediyor...\n");
-    random_delay(2.0, 3.0); // Rastgele gecikme
-    float roof_material_cost1 = 30000.0f; // Malzeme maliyeti
-    float roof_labor_cost1 = roof_material_cost1 * 0.4; // İşçilik maliyeti
-    add_cost(roof_material_cost1, roof_labor_cost1, "roof"); // Maliyeti ekle
+// Güncel toplam maliyeti döndüren fonksiyon
+double current_total_cost(void) {
+    struct CostTotals totals;
+    cost_totals(&totals);
+    return totals.total;
+}
 
-    printf("Asansör sistemleri kuruluyor...\n");
-    random_delay(1.0, 2.0); // Rastgele gecikme
-    float roof_material_cost2 = 30000.0f; // Malzeme maliyeti
-    float roof_labor_cost2 = roof_material_cost2 * 0.4; // İşçilik maliyeti
-    add_cost(roof_material_cost2, roof_labor_cost2, "roof"); // Maliyeti ekle
+// Gün bilgisini ve o güne kadar olan toplam maliyeti yazdıran fonksiyon
+void print_day_info() {
+    int day;
+    if (run_mode == MODE_VIRTUAL) { // Sanal modda gün, sanal saatten hesaplanır (canlı ölçümler de okur)
+        day = (int)virtual_now + 1;
+        atomic_store(&construction_day, day);
+    } else {                        // Gerçek modda her çağrı bir gün sayılır
+        day = atomic_fetch_add(&construction_day, 1);
+    }
+    if (!log_enabled(LOG_LEVEL_PHASE)) return; // Günlük kapalıyken dilimleri boş yere toplama
+    struct LogRecord rec = { .type = LOG_DAY, .floor = day, .a = current_total_cost() };
+    log_push(&rec);
+}
 
-    printf("Ortak alanların dekorasyonu yapılıyor...\n");
-    random_delay(1.5, 2.5); // Rastgele gecikme
-    float roof_material_cost3 = 20000.0f; // Malzeme maliyeti
-    float roof_labor_cost3 = roof_material_cost3 * 0.4; // İşçilik maliyeti
-    add_cost(roof_material_cost3, roof_labor_cost3, "roof"); // Maliyeti ekle
+// Daire adımının ilerlemesini ve maliyetini (kuruş) daire dizilerine ve maliyet matrisine işler.
+// Bir dairenin adımları sırayla tek görevde ilerlediğinden her hücrenin aynı anda tek yazarı vardır.
+void unit_record_step(int floor, int apartment, int step_index, int64_t cost) {
+    long u = (long)floor * apartments_per_floor + apartment;
+    units.cost[unit_column[job_programs[JOB_APARTMENT].steps[step_index].category] * units.stride + u] += (int32_t)cost;
+    atomic_store_explicit(&units.progress[u], (uint8_t)(step_index + 1), memory_order_release);
+}
 
-    printf(COLOR_RED "=== ÇATI KATI TAMAMLANDI ===\n\n" COLOR_RESET);
+// Maliyet matrisi ve kat toplamlarının bayt boyutu (ikisi eşlemede bitişiktir)
+static size_t unit_cost_bytes(void) {
+    return (size_t)((char *)(units.shell + total_floors) - (char *)units.cost);
+}
 
-    // Simülasyon sonu özeti
-    printf(COLOR_GREEN "\n=== İNŞAAT TAMAMLANDI ===\n" COLOR_RESET);
-    printf("Toplam süre: %d gün\n", construction_day-1); // Toplam gün sayısı
-    printf("Toplam maliyet: %.2f TL\n", shared_data->total_cost); // Toplam maliyet
-    printf("Kat başına ortalama maliyet: %.2f TL\n", shared_data->total_cost/TOTAL_FLOORS); // Kat başına maliyet
-    printf("Daire başına ortalama maliyet: %.2f TL\n",
-           shared_data->total_cost/(TOTAL_FLOORS*APARTMENTS_PER_FLOOR)); // Daire başına maliyet
+// ---------------------------------------------------------------------------
+// Canlı ölçümler: tek bina koşusunda ana süreçteki yayıncı thread METRICS_PERIOD_MS'de bir
+// günü, biten katları, aşama başına biten daireleri, kategori maliyetlerini ve kaynak
+// kuyruklarını toplayıp METRICS_NAME paylaşılan belleğine seqlock ile yazar. Yayıncı zaten
+// var olan sayaçları okur (gün, maliyet dilimleri ve dilimlerdeki adım miktarları); işçiler
+// yalnızca zaten tuttukları kuyruk kilidi altında iki sayacı günceller. Yazar tek olduğundan
+// yazma hiç beklemez. Okuyucu (construction-top) bölgeyi salt okunur eşler; sürüm tekse ya da
+// okuma sırasında değiştiyse yeniden okur, yazarı hiçbir zaman durduramaz.
+// ---------------------------------------------------------------------------
 
-    // Maliyet özetini yazdır
-    print_cost_summary();
+#define METRICS_NAME "/construction_metrics" // Ölçüm bölgesinin paylaşılan bellek adı
+#define METRICS_MAGIC 0x314D54524E4F43ULL    // "CONRTM1"
+#define METRICS_PERIOD_MS 10                 // Yayın aralığı
+#define METRICS_STAGES 16                    // Daire aşaması sınırı (daire adım sayısından büyük olmalı)
 
-    // Kaynakları temizle
-    pthread_mutex_destroy(&shared_data->cost_mutex); // Mutex'i yok et
-    munmap(shared_data, sizeof(struct SharedData)); // Paylaşılan belleği serbest bırak
-    shm_unlink("/construction_shm"); // Paylaşılan bellek dosyasını kaldır
+// Bir yayının içeriği
+struct MetricsSnapshot {
+    uint64_t published_ns;              // Yayın anı (CLOCK_MONOTONIC; süreçler arasında ortak)
+    uint64_t publishes;                 // Yayın sayısı
+    int32_t day;                        // Geçerli inşaat günü
+    int32_t mode;                       // enum RunMode
+    int32_t finished;                   // 1: koşu bitti, bu son yayın
+    int32_t floors_total;               // Kat sayısı
+    int32_t floors_done;                // Kaba inşaatı biten kat sayısı
+    int32_t stage_count;                // Daire aşaması sayısı
+    int64_t apartments_total;           // Daire sayısı
+    int64_t stage_done[METRICS_STAGES]; // Aşamayı bitirmiş daire sayısı (son aşama: teslime hazır)
+    double cost[CAT_COUNT];             // Kategori başına maliyet (malzeme + işçilik)
+    double total_cost;                  // Toplam maliyet
+    int32_t crews[RES_COUNT];           // Kaynak başına ekip sayısı
+    int32_t busy[RES_COUNT];            // Çalışan ekip sayısı
+    int32_t queued[RES_COUNT];          // Ekip bekleyen adım sayısı
+};
+
+#define METRICS_WORDS ((sizeof(struct MetricsSnapshot) + 7) / 8)
+
+// Paylaşılan ölçüm bölgesi. Veri atomik sözcüklerle kopyalanır, böylece okuyucunun yırtık
+// gördüğü kopya veri yarışı değil, sürüm denetiminin attığı bir denemedir.
+struct MetricsSegment {
+    uint64_t magic;                        // METRICS_MAGIC
+    uint32_t size;                         // sizeof(struct MetricsSnapshot) (sürüm uyumu)
+    int32_t pid;                           // Yayıncı süreç
+    _Atomic uint32_t seq;                  // Seqlock sürümü (tek: yazılıyor)
+    _Atomic uint64_t words[METRICS_WORDS]; // struct MetricsSnapshot
+};
+
+static _Atomic int live_busy[RES_COUNT];   // Çalışan ekip (kaynak kuyruğu kilidi ya da sanal olay döngüsü yazar)
+static _Atomic int live_queued[RES_COUNT]; // Ekip bekleyen adım
+static atomic_int floors_finished;         // Kaba inşaatı biten kat
+static struct MetricsSegment *metrics;     // Yayıncının eşlemesi (NULL: yayın yok)
+static pthread_t metrics_thread;           // Yayıncı thread
+static pthread_mutex_t metrics_lock = PTHREAD_MUTEX_INITIALIZER; // Yalnızca durdurma isteği için
+static pthread_cond_t metrics_wake;        // Durdurma isteği (CLOCK_MONOTONIC)
+static int metrics_stopping;               // Yayıncıya durma isteği
+static uint64_t metrics_publishes;         // Yapılan yayın sayısı
 
-    sem_destroy(&elevator_sem); // Asansör semaforunu yok et
-    sem_destroy(&stairs_sem);  // Merdiven semaforunu yok et
+// Anlık görüntüyü yazar: sürüm tekleşir, sözcükler kopyalanır, sürüm yeniden çiftleşir
+static void metrics_publish(const struct MetricsSnapshot *snap) {
+    uint64_t words[METRICS_WORDS] = { 0 };
+    memcpy(words, snap, sizeof(*snap));
+    uint32_t seq = atomic_load_explicit(&metrics->seq, memory_order_relaxed);
+    atomic_store_explicit(&metrics->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release); // Sözcükler tek sürümden önce görünmesin
+    for (size_t i = 0; i < METRICS_WORDS; i++) atomic_store_explicit(&metrics->words[i], words[i], memory_order_relaxed);
+    atomic_store_explicit(&metrics->seq, seq + 2, memory_order_release);
+}
+
+// Tutarlı bir görüntü okur; sürüm tekse ya da okurken değiştiyse yeniden dener.
+// Yeniden deneme sayısını döndürür.
+static int metrics_read(struct MetricsSegment *segment, struct MetricsSnapshot *snap) {
+    uint64_t words[METRICS_WORDS];
+    int retries = 0;
+    for (;;) {
+        uint32_t begin = atomic_load_explicit(&segment->seq, memory_order_acquire);
+        if (!(begin & 1)) {
+            for (size_t i = 0; i < METRICS_WORDS; i++) words[i] = atomic_load_explicit(&segment->words[i], memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire); // Sözcükler ikinci sürüm okumasından önce okunmuş olsun
+            if (atomic_load_explicit(&segment->seq, memory_order_relaxed) == begin) break;
+        }
+        retries++;
+        sched_yield(); // Yazar sözcükleri kopyalıyor; kısa sürer
+    }
+    memcpy(snap, words, sizeof(*snap));
+    return retries;
+}
+
+// Var olan sayaçlardan anlık görüntüyü toplayıp yayınlar
+static void metrics_update(int finished) {
+    struct MetricsSnapshot snap;
+    memset(&snap, 0, sizeof(snap));
+    snap.published_ns = monotonic_ns();
+    snap.publishes = ++metrics_publishes;
+    snap.day = atomic_load(&construction_day);
+    snap.mode = run_mode;
+    snap.finished = finished;
+    snap.floors_total = total_floors;
+    snap.floors_done = atomic_load_explicit(&floors_finished, memory_order_relaxed);
+    snap.stage_count = job_programs[JOB_APARTMENT].step_count;
+    snap.apartments_total = units.count;
 
-    // Kat semaforlarını temizle
-    for (int i = 0; i < TOTAL_FLOORS; i++) {
-        snprintf(sem_name, sizeof(sem_name), "/floor_sem_%d", i);
-        sem_close(floor_semaphore[i]); // Semaforu kapat
-        sem_unlink(sem_name); // Semaforu kaldır
+    struct CostTotals totals; // Maliyetler ve aşama sayıları dilimlerden: daire dizisini taramaya gerek yok
+    cost_totals(&totals);
+    for (int i = 0; i <= COST_SHARDS; i++) { // Daire adımının miktarı, o adımı bitiren daire sayısıdır
+        const struct CostShard *shard = i < COST_SHARDS ? &shared_data->shards[i] : &shared_data->overflow;
+        for (int s = 0; s < snap.stage_count; s++) {
+            snap.stage_done[s] += (int64_t)atomic_load_explicit(&shard->quantity[price_item(JOB_APARTMENT, s)], memory_order_relaxed);
+        }
+    }
+    for (int c = 0; c < CAT_COUNT; c++) snap.cost[c] = totals.material[c] + totals.labor[c];
+    snap.total_cost = totals.total;
+    for (int r = 0; r < RES_COUNT; r++) {
+        snap.crews[r] = crew_counts[r];
+        snap.busy[r] = atomic_load_explicit(&live_busy[r], memory_order_relaxed);
+        snap.queued[r] = atomic_load_explicit(&live_queued[r], memory_order_relaxed);
     }
+    metrics_publish(&snap);
+}
+
+// Yayıncı thread: durdurulana kadar METRICS_PERIOD_MS'de bir yayınlar
+static void *metrics_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&metrics_lock);
+    while (!metrics_stopping) {
+        pthread_mutex_unlock(&metrics_lock);
+        metrics_update(0);
+        uint64_t due = monotonic_ns() + METRICS_PERIOD_MS * 1000000ULL;
+        struct timespec until = { (time_t)(due / 1000000000ULL), (long)(due % 1000000000ULL) };
+        pthread_mutex_lock(&metrics_lock);
+        if (!metrics_stopping) pthread_cond_timedwait(&metrics_wake, &metrics_lock, &until);
+    }
+    pthread_mutex_unlock(&metrics_lock);
+    return NULL;
+}
+
+// Ölçüm bölgesini oluşturur ve yayıncıyı başlatır. Önceki (çökmüş) koşudan kalan bölge
+// silinir; ona bağlı okuyucu, yayıncısının öldüğünü görüp yenisine bağlanır.
+void metrics_start(void) {
+    shm_unlink(METRICS_NAME);
+    int fd = shm_open(METRICS_NAME, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd == -1 || ftruncate(fd, sizeof(struct MetricsSegment)) == -1) {
+        perror("ölçüm bölgesi oluşturulamadı");
+        exit(EXIT_FAILURE);
+    }
+    metrics = mmap(NULL, sizeof(struct MetricsSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (metrics == MAP_FAILED) {
+        perror("mmap failed");
+        exit(EXIT_FAILURE);
+    }
+    metrics->size = sizeof(struct MetricsSnapshot);
+    metrics->pid = getpid();
+    for (int r = 0; r < RES_COUNT; r++) {
+        atomic_store(&live_busy[r], 0);
+        atomic_store(&live_queued[r], 0);
+    }
+    atomic_store(&floors_finished, 0);
+    metrics_publishes = 0;
+    metrics_update(0);
+    atomic_thread_fence(memory_order_release);
+    metrics->magic = METRICS_MAGIC; // Okuyucu bölgeyi ilk yayından sonra geçerli sayar
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&metrics_wake, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    metrics_stopping = 0;
+    pthread_create(&metrics_thread, NULL, metrics_main, NULL);
+}
+
+// Yayıncıyı durdurur, son durumu bitti işaretiyle yayınlar ve bölgenin adını siler
+// (bağlı okuyucu eşlemesini korur ve son görüntüyü okuyabilir)
+void metrics_stop(void) {
+    if (!metrics) return;
+    pthread_mutex_lock(&metrics_lock);
+    metrics_stopping = 1;
+    pthread_cond_signal(&metrics_wake);
+    pthread_mutex_unlock(&metrics_lock);
+    pthread_join(metrics_thread, NULL);
+    pthread_cond_destroy(&metrics_wake);
+    metrics_update(1);
+    munmap(metrics, sizeof(struct MetricsSegment));
+    metrics = NULL;
+    shm_unlink(METRICS_NAME);
+}
+
+// Fiyat tablosunu adım tablolarındaki fiyatlar ve güncel ekip ücretleriyle doldurur
+void price_table_init(struct PriceTable *table) {
+    int item = 0;
+    for (int k = 0; k < JOB_KIND_COUNT; k++) item += job_programs[k].step_count;
+    if (item > MAX_PRICE_ITEMS) { // Tabloya yazmadan önce: sınır aşılırsa dizinin dışına taşılmasın
+        fprintf(stderr, "Fiyat kalemi sayısı MAX_PRICE_ITEMS sınırını aşıyor (%d > %d)\n", item, MAX_PRICE_ITEMS);
+        exit(EXIT_FAILURE);
+    }
+    item = 0;
+    for (int k = 0; k < JOB_KIND_COUNT; k++) {
+        price_item_base[k] = item;
+        for (int i = 0; i < job_programs[k].step_count; i++) table->material[item++] = job_programs[k].steps[i].material_cost;
+    }
+    price_item_count = item;
+    for (int c = 0; c < CAT_COUNT; c++) table->labor_ratio[c] = DEFAULT_LABOR_RATIO;
+    for (int r = 0; r < RES_COUNT; r++) table->crew_day[r] = crew_day_costs[r];
+}
+
+// Adımın bir kez yapılmasıyla tüketilen fiyat kalemi miktarı (kat başına fiyatlı adımda kat sayısı)
+static inline double step_quantity(const struct TaskStep *step) {
+    return step->per_floor ? total_floors : 1.0;
+}
+
+// Adımın bir kezlik malzeme ve işçilik maliyetini (kuruş) verilen fiyat tablosundan hesaplar. Tutar
+// double fiyattan doğrudan kuruşa yuvarlanır, işçilik de yuvarlanmış malzemeden; defter ve yeniden
+// fiyatlama aynı tutarı kullanır
+void step_cost_with(const struct PriceTable *table, enum JobKind kind, int step_index, int64_t *material, int64_t *labor) {
+    const struct TaskStep *step = &job_programs[kind].steps[step_index];
+    *material = kurus_round(table->material[price_item(kind, step_index)] * step_quantity(step) * 100.0);
+    *labor = kurus_round(*material * table->labor_ratio[step->category]); // İşçilik malzemeye oranla
+}
+
+// Adımın malzeme ve işçilik maliyeti (kuruş), koşunun fiyatlarıyla
+void step_cost(enum JobKind kind, int step_index, int64_t *material, int64_t *labor) {
+    step_cost_with(&prices, kind, step_index, material, labor);
+}
+
+// Ekiplerin şantiyede geçirdiği günlerin ücreti: her ekip, iş olsun olmasın bina bitene kadar ödenir
+double crew_cost(const int *crews, double days) {
+    double per_day = 0.0;
+    for (int r = 0; r < RES_COUNT; r++) per_day += (double)crews[r] * crew_day_costs[r];
+    return per_day * days;
+}
+
+static double crew_days[RES_COUNT]; // Deftere yazılan ekip-gün miktarı (yeniden fiyatlama için)
+
+// Ekip günlüklerini deftere ekler ve ekip-gün miktarını kaydeder (yalnızca ana süreç çağırır)
+void add_crew_cost(const int *crews, double days) {
+    for (int r = 0; r < RES_COUNT; r++) crew_days[r] += (double)crews[r] * days;
+    add_cost(0.0, crew_cost(crews, days), CAT_CREW);
+}
+
+static struct FloorMessage *floor_pending; // Kat sürecinde: adım maliyetlerinin biriktiği bildirim (NULL: doğrudan deftere)
+
+// Kat adımının maliyetini (kuruş) deftere ve katın kaba inşaat toplamına işler
+static void post_floor_step(int step_index, int floor, int64_t material, int64_t labor) {
+    const struct TaskStep *step = &job_programs[JOB_FLOOR].steps[step_index];
+    units.shell[floor] += material + labor;
+    // Miktar, fiyatı şu an 0 olan adımlarda da kaydedilir: yeni fiyatla yeniden hesaplanabilsin
+    ledger_add(material, labor, step->category, price_item(JOB_FLOOR, step_index), step_quantity(step));
+}
+
+// Adımın maliyetini ekleyen fonksiyon; daire adımları maliyet matrisine, kat adımları katın
+// kaba inşaat toplamına da işlenir (kat adımları katın tek sürecinde sırayla yürür). Kat
+// sürecindeki kat adımları bildirimde birikir, deftere ana süreç işler.
+void add_step_cost(enum JobKind kind, int step_index, int floor, int apartment) {
+    const struct TaskStep *step = &job_programs[kind].steps[step_index];
+    int64_t material, labor;
+    step_cost(kind, step_index, &material, &labor);
+    if (kind == JOB_FLOOR && floor_pending) {
+        // Maliyet deftere de günlüğe de ana süreçteki bildirimle girer (çöken deneme sayılmaz)
+        event_log_step(kind, floor, apartment, step_index, 1, 0, 0);
+        floor_pending->material[step_index] += material;
+        floor_pending->labor[step_index] += labor;
+    } else if (kind == JOB_FLOOR) {
+        event_log_step(kind, floor, apartment, step_index, 1, material, labor); // Adım bitişi
+        post_floor_step(step_index, floor, material, labor);
+    } else {
+        event_log_step(kind, floor, apartment, step_index, 1, material, labor); // Adım bitişi
+        if (kind == JOB_APARTMENT) unit_record_step(floor, apartment, step_index, material + labor);
+        // Miktar, fiyatı şu an 0 olan adımlarda da kaydedilir: yeni fiyatla yeniden hesaplanabilsin
+        ledger_add(material, labor, step->category, price_item(kind, step_index), step_quantity(step));
+    }
+    if (material <= 0) return;                   // Maliyeti olmayan ara adım
+    log_cost(step->category, material / 100.0, labor / 100.0);
+}
+
+// ---------------------------------------------------------------------------
+// Kaynak çekişmesi ölçümü: her kaynak için edinme beklemesi ve tutma süresi, HDR tarzı
+// log-doğrusal kovalarda tutulur. Her thread kendi sayaçlarına kilitsiz yazar; rapor
+// sırasında tüm thread'lerin sayaçları birleştirilir. Gerçek modda birim nanosaniye,
+// sanal modda simüle edilen saniyedir.
+// ---------------------------------------------------------------------------
+
+#define HIST_SUB_BITS 3                                   // İkinin her kuvveti 8 alt kovaya bölünür (~%12 çözünürlük)
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB) // 64 bitlik tüm değerleri kapsar
+
+// Log-doğrusal histogram
+struct Histogram {
+    uint64_t counts[HIST_BUCKETS];  // Kova başına örnek sayısı
+    uint64_t count;                 // Toplam örnek sayısı
+    uint64_t sum;                   // Örneklerin toplamı
+    uint64_t max;                   // En büyük örnek
+};
+
+// Bir thread'in kaynak sayaçları
+struct ResourceStats {
+    struct Histogram wait[RES_COUNT];  // Edinme beklemesi
+    struct Histogram hold[RES_COUNT];  // Tutma süresi
+    uint64_t contended[RES_COUNT];     // Kaynak meşgulken gelen edinme sayısı
+    uint64_t hold_start[RES_COUNT];    // Tutmaya başlama anı (gerçek mod)
+    struct ResourceStats *next;        // Tüm thread'lerin sayaç listesi
+};
+
+// Kaynak adları ve rapor etiketleri (tablo hizası için doldurulmuş)
+static const char *resource_names[RES_COUNT] = { "elektrik ekibi", "sıhhi tesisat ekibi", "boya ekibi", "asansör" };
+static const char *resource_labels[RES_COUNT] = {
+    "Elektrik ekibi     ", "Sıhhi tesisat ekibi", "Boya ekibi         ", "Asansör            "
+};
+
+static __thread struct ResourceStats *resource_stats;        // Bu thread'in sayaçları
+static struct ResourceStats *resource_stats_list;            // Kayıtlı tüm sayaçlar
+static pthread_mutex_t resource_stats_lock = PTHREAD_MUTEX_INITIALIZER; // Yalnızca listeye kayıt için
+
+// Değerin kova indeksini döndürür: ilk HIST_SUB değer tam, sonrası ikinin kuvveti başına HIST_SUB kova
+static int hist_bucket(uint64_t value) {
+    if (value < HIST_SUB) return (int)value;
+    int shift = 63 - __builtin_clzll(value) - HIST_SUB_BITS;
+    return (shift + 1) * HIST_SUB + (int)((value >> shift) & (HIST_SUB - 1));
+}
+
+// Kovanın orta değerini döndürür
+static uint64_t hist_bucket_value(int bucket) {
+    if (bucket < HIST_SUB) return (uint64_t)bucket;
+    int shift = bucket / HIST_SUB - 1;
+    uint64_t low = (uint64_t)(HIST_SUB + bucket % HIST_SUB) << shift;
+    return low + ((1ULL << shift) >> 1);
+}
+
+// Histograma örnek ekler
+static void hist_add(struct Histogram *h, uint64_t value) {
+    h->counts[hist_bucket(value)]++;
+    h->count++;
+    h->sum += value;
+    if (value > h->max) h->max = value;
+}
+
+// İkinci histogramı birinciye ekler
+static void hist_merge(struct Histogram *into, const struct Histogram *from) {
+    for (int b = 0; b < HIST_BUCKETS; b++) into->counts[b] += from->counts[b];
+    into->count += from->count;
+    into->sum += from->sum;
+    if (from->max > into->max) into->max = from->max;
+}
+
+// q yüzdeliğindeki değeri (kova orta değeri, en büyük örnekle sınırlı) döndürür
+static uint64_t hist_percentile(const struct Histogram *h, double q) {
+    if (h->count == 0) return 0;
+    uint64_t rank = (uint64_t)(q * h->count);
+    if (rank < q * h->count) rank++;
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        seen += h->counts[b];
+        if (seen >= rank) {
+            uint64_t value = hist_bucket_value(b);
+            return value < h->max ? value : h->max;
+        }
+    }
+    return h->max;
+}
+
+// Bu thread'in sayaçlarını döndürür; ilk çağrıda ayırıp listeye kaydeder
+static struct ResourceStats *resource_stats_local(void) {
+    if (!resource_stats) {
+        resource_stats = calloc(1, sizeof(struct ResourceStats));
+        if (!resource_stats) {
+            perror("calloc failed");
+            exit(EXIT_FAILURE);
+        }
+        pthread_mutex_lock(&resource_stats_lock);
+        resource_stats->next = resource_stats_list;
+        resource_stats_list = resource_stats;
+        pthread_mutex_unlock(&resource_stats_lock);
+    }
+    return resource_stats;
+}
+
+// Edinme beklemesini kaydeder
+void resource_stats_wait(enum ResourceId res, uint64_t ticks, int contended) {
+    struct ResourceStats *st = resource_stats_local();
+    hist_add(&st->wait[res], ticks);
+    if (contended) st->contended[res]++;
+}
+
+// Tutma süresini kaydeder
+void resource_stats_hold(enum ResourceId res, uint64_t ticks) {
+    hist_add(&resource_stats_local()->hold[res], ticks);
+}
+
+// Gerçek modda kaynaktan bir ekip (ya da asansör) alan fonksiyon; her kaynak ekip sayısı kadar
+// değerle başlayan sayan bir semafordur. Önce beklemeden denenir; tüm ekipler meşgulse bekleme süresi ölçülür.
+void resource_acquire(enum ResourceId res) {
+    if (res == RES_NONE) return;
+    int busy = sem_trywait(&resource_sem[res]) != 0;
+    uint64_t now;
+    if (busy) {
+        uint64_t start = monotonic_ns();
+        while (sem_wait(&resource_sem[res]) != 0) { } // Boşa çıkan ilk ekibi bekle (EINTR'de yeniden)
+        now = monotonic_ns();
+        resource_stats_wait(res, now - start, 1);
+        trace_span(TRACE_RESOURCE_WAIT, res, -1, -1, start - trace_epoch, 0, 0, -1);
+    } else {
+        now = monotonic_ns();
+        resource_stats_wait(res, 0, 0);
+    }
+    resource_stats_local()->hold_start[res] = now;
+}
+
+// Gerçek modda kaynağı serbest bırakan fonksiyon
+void resource_release(enum ResourceId res) {
+    if (res == RES_NONE) return;
+    resource_stats_hold(res, monotonic_ns() - resource_stats_local()->hold_start[res]);
+    sem_post(&resource_sem[res]); // Ekibi sıradaki işe bırak
+}
+
+// Bir adımı gerçek zamanlı olarak çalıştıran fonksiyon: kaynak al, bekle, bırak, maliyet ekle
+void run_step(enum JobKind kind, int step_index, int floor, int apartment) {
+    const struct TaskStep *step = &job_programs[kind].steps[step_index];
+    resource_acquire(step->resource);
+    log_step(kind, floor, apartment, step_index, 0);
+    random_delay(step->min_sec, step->max_sec);       // Rastgele gecikme ile işlemi simüle et
+    log_step(kind, floor, apartment, step_index, 1);
+    resource_release(step->resource);
+    add_step_cost(kind, step_index, floor, apartment); // Maliyeti kaynak bırakıldıktan sonra ekle
+}
+
+// Bir işin tüm adımlarını sırayla gerçek zamanlı çalıştıran fonksiyon
+void run_job(enum JobKind kind, int floor, int apartment) {
+    const struct JobProgram *program = &job_programs[kind];
+    log_job(kind, floor, apartment, 0);
+    for (int i = 0; i < program->step_count; i++) {
+        run_step(kind, i, floor, apartment);
+    }
+    log_job(kind, floor, apartment, 1);
+}
+
+// ---------------------------------------------------------------------------
+// Bağımlılık grafiği: her iş bir düğüm, her "önce bu bitmeli" kuralı bir kenardır.
+// Sanal ve gerçek yürütücüler bir düğümü tüm öncülleri bittiği anda serbest bırakır.
+// ---------------------------------------------------------------------------
+
+// Zamanlama biçimleri (grafın kenarlarını belirler)
+enum ScheduleMode {
+    SCHEDULE_PIPELINE,  // Kat kabası biter bitmez o katın iç dizaynı başlar (varsayılan)
+    SCHEDULE_SERIAL     // Eski sıra: tüm katlar, çatı iskeleti, kat kat iç dizayn, en son çatı
+};
+
+static const char *schedule_names[] = { "boru hattı", "sıralı (eski)" };
+static const char *schedule_labels[] = { "Boru hattı    ", "Sıralı (eski) " }; // Tablo hizası için doldurulmuş
+enum ScheduleMode schedule_mode = SCHEDULE_PIPELINE; // Seçili zamanlama
+
+// Graf düğümü: işin türü ve yeri
+struct GraphNode {
+    enum JobKind kind;  // İş türü
+    int floor;          // Kat numarası (-1: binaya ait)
+    int apartment;      // Daire numarası (-1: kata ait)
+};
+
+// Değişmeyen bağımlılık grafiği; n düğümünün ardılları succ[succ_start[n] .. succ_start[n+1]) aralığındadır
+struct TaskGraph {
+    struct GraphNode *nodes;  // Düğümler
+    int node_count;           // Düğüm sayısı
+    int *indegree;            // Düğüm başına öncül sayısı
+    int *succ_start;          // Ardıl listelerinin başlangıçları (node_count + 1 eleman)
+    int *succ;                // Ardıl düğümler
+    int edge_count;           // Kenar sayısı
+};
+
+// Düğüm indeksleri: temel, katlar, çatı iskeleti, daireler, kat iç dizayn noktaları, çatı
+static int graph_floor_node(int floor) { return 1 + floor; }
+static int graph_roof_skeleton_node(void) { return 1 + total_floors; }
+static int graph_apartment_node(int floor, int apartment) { return 2 + total_floors + floor * apartments_per_floor + apartment; }
+static int graph_interior_node(int floor) { return 2 + total_floors + total_floors * apartments_per_floor + floor; }
+static int graph_roof_node(void) { return 2 + 2 * total_floors + total_floors * apartments_per_floor; }
+
+// İşin düğüm indeksini türünden ve yerinden hesaplar
+static int graph_job_node(enum JobKind kind, int floor, int apartment) {
+    switch (kind) {
+    case JOB_FLOOR:         return graph_floor_node(floor);
+    case JOB_ROOF_SKELETON: return graph_roof_skeleton_node();
+    case JOB_APARTMENT:     return graph_apartment_node(floor, apartment);
+    case JOB_INTERIOR:      return graph_interior_node(floor);
+    case JOB_ROOF:          return graph_roof_node();
+    default:                return 0; // Temel atma
+    }
+}
+
+// Kenarı geçici listeye ekler (from bitmeden to başlayamaz)
+static void graph_add_edge(int (**edges)[2], int *count, int *capacity, int from, int to) {
+    if (*count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 64;
+        *edges = realloc(*edges, *capacity * sizeof(**edges));
+        if (!*edges) {
+            perror("realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+    (*edges)[*count][0] = from;
+    (*edges)[*count][1] = to;
+    (*count)++;
+}
+
+// Seçilen zamanlama biçimine göre grafı kurar
+void graph_build(struct TaskGraph *g, enum ScheduleMode mode) {
+    memset(g, 0, sizeof(*g));
+    g->node_count = graph_roof_node() + 1;
+    g->nodes = calloc(g->node_count, sizeof(struct GraphNode));
+    g->indegree = calloc(g->node_count, sizeof(int));
+    g->succ_start = calloc(g->node_count + 1, sizeof(int));
+    if (!g->nodes || !g->indegree || !g->succ_start) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Düğümler
+    g->nodes[0] = (struct GraphNode){ JOB_FOUNDATION, -1, -1 };
+    for (int f = 0; f < total_floors; f++) {
+        g->nodes[graph_floor_node(f)] = (struct GraphNode){ JOB_FLOOR, f, -1 };
+        g->nodes[graph_interior_node(f)] = (struct GraphNode){ JOB_INTERIOR, f, -1 };
+        for (int a = 0; a < apartments_per_floor; a++) {
+            g->nodes[graph_apartment_node(f, a)] = (struct GraphNode){ JOB_APARTMENT, f, a };
+        }
+    }
+    g->nodes[graph_roof_skeleton_node()] = (struct GraphNode){ JOB_ROOF_SKELETON, -1, -1 };
+    g->nodes[graph_roof_node()] = (struct GraphNode){ JOB_ROOF, -1, -1 };
+
+    // Kenarlar: kaba inşaat her iki biçimde de temelden çatı iskeletine kat kat ilerler
+    int (*edges)[2] = NULL;
+    int count = 0, capacity = 0;
+    graph_add_edge(&edges, &count, &capacity, 0, graph_floor_node(0));
+    for (int f = 0; f < total_floors; f++) {
+        int next = f < total_floors - 1 ? graph_floor_node(f + 1) : graph_roof_skeleton_node();
+        graph_add_edge(&edges, &count, &capacity, graph_floor_node(f), next);
+    }
+    for (int f = 0; f < total_floors; f++) {
+        // Boru hattında daireler kendi katının kabasını, sıralıda bir önceki katın iç dizaynını bekler
+        int gate;
+        if (mode == SCHEDULE_PIPELINE) gate = graph_floor_node(f);
+        else gate = f == 0 ? graph_roof_skeleton_node() : graph_interior_node(f - 1);
+        for (int a = 0; a < apartments_per_floor; a++) {
+            graph_add_edge(&edges, &count, &capacity, gate, graph_apartment_node(f, a));
+            graph_add_edge(&edges, &count, &capacity, graph_apartment_node(f, a), graph_interior_node(f));
+        }
+        if (mode == SCHEDULE_PIPELINE || f == total_floors - 1) {
+            graph_add_edge(&edges, &count, &capacity, graph_interior_node(f), graph_roof_node());
+        }
+    }
+    if (mode == SCHEDULE_PIPELINE) graph_add_edge(&edges, &count, &capacity, graph_roof_skeleton_node(), graph_roof_node());
+
+    // Kenar listesini düğüm başına ardıl dizilerine (CSR) çevir
+    g->edge_count = count;
+    g->succ = malloc(count * sizeof(int));
+    if (!g->succ) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int e = 0; e < count; e++) {
+        g->succ_start[edges[e][0] + 1]++;
+        g->indegree[edges[e][1]]++;
+    }
+    for (int n = 0; n < g->node_count; n++) g->succ_start[n + 1] += g->succ_start[n];
+    int *fill = calloc(g->node_count, sizeof(int));
+    if (!fill) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int e = 0; e < count; e++) {
+        int from = edges[e][0];
+        g->succ[g->succ_start[from] + fill[from]++] = edges[e][1];
+    }
+    free(fill);
+    free(edges);
+}
+
+// Grafın belleğini serbest bırakır
+void graph_free(struct TaskGraph *g) {
+    free(g->nodes);
+    free(g->indegree);
+    free(g->succ_start);
+    free(g->succ);
+}
+
+// Düğüm serbest kaldığında gün ve aşama başlıklarını yazar (iş başlığını yürütücü yazar)
+void graph_node_released(const struct GraphNode *node) {
+    switch (node->kind) {
+    case JOB_FLOOR:
+    case JOB_ROOF_SKELETON:
+        print_day_info();
+        break;
+    case JOB_APARTMENT: // Katın ilk dairesi o katın iç dizayn aşamasını açar
+        if (node->apartment != 0) break;
+        if (node->floor == 0) log_message(MSG_INTERIOR_START, 0, 0);
+        print_day_info();
+        log_message(MSG_INTERIOR_FLOOR_START, node->floor+1, 0);
+        break;
+    case JOB_ROOF: // Çatı tüm iç dizayn noktalarından sonra gelir
+        log_message(MSG_INTERIOR_DONE, 0, 0);
+        print_day_info();
+        break;
+    default:
+        break;
+    }
+}
+
+// Düğüm bittiğinde aşama bitiş başlığını yazar
+void graph_node_finished(const struct GraphNode *node) {
+    if (node->kind == JOB_FLOOR) atomic_fetch_add_explicit(&floors_finished, 1, memory_order_relaxed); // Canlı ölçümler için
+    if (node->kind == JOB_INTERIOR) log_message(MSG_INTERIOR_FLOOR_DONE, node->floor+1, 0);
+}
+
+static const char *job_kind_labels[JOB_KIND_COUNT] = {
+    "Temel atma", "Kat kaba inşaatı", "Çatı iskeleti", "Daire iç dizayn", "Çatı katı", "İç dizayn noktası"
+};
+
+// ---------------------------------------------------------------------------
+// Kritik yol ve bolluk: tek bina koşusunda her düğümün serbest kalma ve bitiş anı, kaynak
+// kuyruklarında beklediği süre ve onu serbest bırakan son öncülü kaydedilir (sanal modda gün,
+// gerçek modda saniye). Koşu bitince kritik yol çatıdan geriye, düğümü bırakan öncüller
+// izlenerek bulunur; bolluk, yürütülen sürelerle ters topolojik sırada hesaplanan en geç bitiş
+// anından gelir. İkisi de düğüm ve kenar sayısında doğrusaldır. Kaba yapı düğümlerinin adım
+// süreleri de tutulur; kritik yoldaki süre aşamalara ve ekip beklemelerine bölünür.
+// ---------------------------------------------------------------------------
+
+#define SCHEDULE_STEPS 4  // Adım süresi tutulan kaba yapı işlerinin en fazla adım sayısı
+
+// Düğümün yürütülen programdaki kaydı
+struct NodeTiming {
+    double finished;          // Bitiş anı (düğüm bitene kadar serbest kalma anı)
+    float span;               // Serbest kalmadan bitişe geçen süre
+    float wait[RES_COUNT];    // Kaynak kuyruklarında geçen süre
+    int32_t driver;           // Düğümü serbest bırakan son öncül (-1: öncülü yok)
+};
+
+// Koşunun kaydı; nodes NULL ise kayıt kapalıdır (karşılaştırma, toplu ve portföy koşuları)
+struct ScheduleLog {
+    const struct TaskGraph *graph;
+    struct NodeTiming *nodes;  // Düğüm başına kayıt
+    float *steps;              // Kaba yapı düğümü başına SCHEDULE_STEPS adım süresi
+    uint64_t epoch_ns;         // Gerçek modda zaman sıfırı
+};
+
+static struct ScheduleLog schedule_log;
+static const char *slack_path;  // --slack ile verilen CSV dosyası (NULL: yazılmaz)
+
+// Kaydın zamanı: sanal saat ya da koşu başından beri geçen saniye
+static double schedule_now(void) {
+    return run_mode == MODE_VIRTUAL ? virtual_now : (monotonic_ns() - schedule_log.epoch_ns) / 1e9;
+}
+
+// Kaba yapı düğümünün adım satırı: temel, katlar ve çatı iskeleti düğüm sırasıyla, ardından çatı
+static int schedule_step_row(int node) {
+    if (node <= graph_roof_skeleton_node()) return node;
+    return node == graph_roof_node() ? graph_roof_skeleton_node() + 1 : -1;
+}
+
+// Adım sürelerinin boyutu: kaba yapı düğümü başına SCHEDULE_STEPS süre
+static size_t schedule_steps_bytes(void) {
+    return (size_t)(graph_roof_skeleton_node() + 2) * SCHEDULE_STEPS * sizeof(float);
+}
+
+// Kaydı koşudan hemen önce açar
+void schedule_log_init(const struct TaskGraph *graph) {
+    schedule_log.graph = graph;
+    schedule_log.nodes = calloc(graph->node_count, sizeof(struct NodeTiming));
+    schedule_log.steps = calloc(1, schedule_steps_bytes());
+    if (!schedule_log.nodes || !schedule_log.steps) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    schedule_log.epoch_ns = monotonic_ns();
+}
+
+void schedule_log_free(void) {
+    free(schedule_log.nodes);
+    free(schedule_log.steps);
+    schedule_log.nodes = NULL;
+    schedule_log.steps = NULL;
+}
+
+// Düğümün öncülleri bitti; driver sonuncusudur
+static void schedule_released(int node, int driver) {
+    if (!schedule_log.nodes) return;
+    schedule_log.nodes[node].finished = schedule_now();
+    schedule_log.nodes[node].driver = driver;
+}
+
+// Düğüm kaynağı kuyrukta bekleyerek aldı
+static void schedule_waited(int node, enum ResourceId res, double wait) {
+    if (schedule_log.nodes) schedule_log.nodes[node].wait[res] += (float)wait;
+}
+
+// Düğümün adımı duration sürecek (yalnızca kaba yapı düğümlerinde tutulur)
+static void schedule_step(int node, int step, double duration) {
+    int row = schedule_step_row(node);
+    if (schedule_log.nodes && row >= 0 && step < SCHEDULE_STEPS) schedule_log.steps[row * SCHEDULE_STEPS + step] += (float)duration;
+}
+
+// Düğüm bitti
+static void schedule_finished(int node) {
+    if (!schedule_log.nodes) return;
+    struct NodeTiming *t = &schedule_log.nodes[node];
+    double now = schedule_now();
+    t->span = (float)(now - t->finished);
+    t->finished = now;
+}
+
+// Kritik yolun bir kalemi: bir aşamanın işi ya da bir kaynağın beklemesi
+struct CriticalShare {
+    char label[96];
+    double time;              // Kritik yolda geçen süre
+    enum ResourceId resource; // Bekleme kalemiyse kaynak, değilse RES_NONE
+};
+
+// İş türü başına bolluk özeti
+struct SlackSummary {
+    long count, critical;
+    double min, sum;
+};
+
+// Analizin sonucu (graf serbest bırakılmadan hesaplanır, rapor sonra yazdırılır)
+struct CriticalPath {
+    double makespan;                    // Çatının bitişi
+    double epsilon;                     // Bu kadar bolluk kritik sayılır
+    int *path;                          // Kritik yol, baştan sona düğümler
+    struct GraphNode *path_nodes;       // Yoldaki düğümlerin türü ve yeri
+    struct NodeTiming *path_timing;     // Yoldaki düğümlerin kaydı
+    int path_length;
+    struct CriticalShare shares[MAX_PRICE_ITEMS + JOB_KIND_COUNT + RES_COUNT + 1];
+    int share_count;                    // Süreye göre azalan sırada
+    struct SlackSummary kinds[JOB_KIND_COUNT];
+    struct GraphNode nearest;           // Kritik olmayanlar içinde en az bolluklu düğüm
+    double nearest_slack;               // Onun bolluğu (< 0: yok)
+    double analysis_ms;                 // Analiz süresi
+};
+
+// Adımın görünen adı: başlangıç mesajı, sondaki "..." olmadan
+static void step_label(char *buf, size_t size, int kind, int step_index) {
+    const char *msg = job_programs[kind].steps[step_index].start_msg;
+    size_t len = strlen(msg);
+    while (len > 0 && msg[len - 1] == '.') len--;
+    snprintf(buf, size, "%.*s", (int)len, msg);
+}
+
+static int critical_share_compare(const void *a, const void *b) {
+    double x = ((const struct CriticalShare *)a)->time, y = ((const struct CriticalShare *)b)->time;
+    return (x < y) - (x > y);
+}
+
+// Kayıttan kritik yolu, düğüm başına bolluğu ve kritik yolun aşama/kaynak bileşimini hesaplar;
+// --slack verildiyse her düğümü CSV olarak yazar. Kayıt açık değilse 0 döndürür.
+int critical_path_compute(struct CriticalPath *cp) {
+    const struct TaskGraph *g = schedule_log.graph;
+    const struct NodeTiming *t = schedule_log.nodes;
+    if (!t) return 0;
+    uint64_t start = monotonic_ns();
+    int n = g->node_count;
+    memset(cp, 0, sizeof(*cp));
+    cp->makespan = t[graph_roof_node()].finished; // Grafın tek çıkışı çatıdır
+    cp->epsilon = cp->makespan * 1e-5;
+
+    // Topolojik sıra (Kahn), sonra ters sırada en geç bitiş: ardılın en geç bitişinden süresi ve
+    // son öncülünün bitişiyle kendi serbest kalışı arasındaki dağıtım gecikmesi çıkar
+    int *order = malloc(n * sizeof(int));
+    int *indegree = malloc(n * sizeof(int));
+    double *late = malloc(n * sizeof(double));
+    if (!order || !indegree || !late) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(indegree, g->indegree, n * sizeof(int));
+    int head = 0, tail = 0;
+    for (int i = 0; i < n; i++) if (indegree[i] == 0) order[tail++] = i;
+    while (head < tail) {
+        int v = order[head++];
+        for (int e = g->succ_start[v]; e < g->succ_start[v + 1]; e++) {
+            if (--indegree[g->succ[e]] == 0) order[tail++] = g->succ[e];
+        }
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        int v = order[i];
+        double lf = cp->makespan;
+        for (int e = g->succ_start[v]; e < g->succ_start[v + 1]; e++) {
+            int s = g->succ[e];
+            double need = t[s].finished - t[t[s].driver].finished; // Gecikme ve süre (s'nin öncülü vardır)
+            if (late[s] - need < lf) lf = late[s] - need;
+        }
+        late[v] = lf;
+    }
+
+    // Bolluk özeti ve CSV
+    FILE *csv = NULL;
+    if (slack_path) {
+        csv = fopen(slack_path, "w");
+        if (!csv) {
+            perror("bolluk dosyası açılamadı");
+            exit(EXIT_FAILURE);
+        }
+        fprintf(csv, "dugum,tur,kat,daire,serbest,bitis,sure,bolluk,kritik,bekleme_elektrik,bekleme_tesisat,bekleme_boya,bekleme_asansor\n");
+    }
+    cp->nearest_slack = -1.0;
+    for (int k = 0; k < JOB_KIND_COUNT; k++) cp->kinds[k].min = -1.0;
+    for (int v = 0; v < n; v++) {
+        const struct GraphNode *node = &g->nodes[v];
+        double slack = late[v] - t[v].finished;
+        if (slack < 0.0) slack = 0.0; // Kayan nokta payı
+        int critical = slack <= cp->epsilon;
+        struct SlackSummary *s = &cp->kinds[node->kind];
+        s->count++;
+        s->critical += critical;
+        s->sum += slack;
+        if (s->min < 0.0 || slack < s->min) s->min = slack;
+        if (!critical && node->kind != JOB_INTERIOR && (cp->nearest_slack < 0.0 || slack < cp->nearest_slack)) {
+            cp->nearest_slack = slack;
+            cp->nearest = *node;
+        }
+        if (csv) {
+            fprintf(csv, "%d,%s,%d,%d,%.6f,%.6f,%.6f,%.6f,%d,%.6f,%.6f,%.6f,%.6f\n", v, job_kind_labels[node->kind],
+                    node->floor + 1, node->apartment + 1, t[v].finished - t[v].span, t[v].finished, (double)t[v].span,
+                    slack, critical, (double)t[v].wait[RES_ELECTRIC], (double)t[v].wait[RES_PLUMBING],
+                    (double)t[v].wait[RES_PAINT], (double)t[v].wait[RES_ELEVATOR]);
+        }
+    }
+    if (csv && fclose(csv) != 0) {
+        perror("bolluk dosyası yazılamadı");
+        exit(EXIT_FAILURE);
+    }
+
+    // Kritik yol: çatıdan geriye, her düğümü serbest bırakan öncül (order dizisi yeniden kullanılır)
+    int length = 0;
+    for (int v = graph_roof_node(); v >= 0; v = t[v].driver) order[length++] = v;
+    cp->path = malloc(length * sizeof(int));
+    cp->path_nodes = malloc(length * sizeof(struct GraphNode));
+    cp->path_timing = malloc(length * sizeof(struct NodeTiming));
+    if (!cp->path || !cp->path_nodes || !cp->path_timing) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    cp->path_length = length;
+    double step_time[MAX_PRICE_ITEMS] = { 0 }, kind_time[JOB_KIND_COUNT] = { 0 }, wait_time[RES_COUNT] = { 0 };
+    double gaps = t[order[length - 1]].finished - t[order[length - 1]].span; // İlk düğüm sıfırda serbest kalır
+    for (int i = 0; i < length; i++) {
+        int v = order[length - 1 - i];
+        const struct GraphNode *node = &g->nodes[v];
+        cp->path[i] = v;
+        cp->path_nodes[i] = *node;
+        cp->path_timing[i] = t[v];
+        if (t[v].driver >= 0) gaps += t[v].finished - t[v].span - t[t[v].driver].finished;
+        double work = t[v].span;
+        for (int r = 0; r < RES_COUNT; r++) {
+            wait_time[r] += t[v].wait[r];
+            work -= t[v].wait[r];
+        }
+        int row = schedule_step_row(v);
+        for (int s = 0; row >= 0 && s < job_programs[node->kind].step_count && s < SCHEDULE_STEPS; s++) {
+            double d = schedule_log.steps[row * SCHEDULE_STEPS + s];
+            step_time[price_item(node->kind, s)] += d;
+            work -= d;
+        }
+        if (work > cp->epsilon) kind_time[node->kind] += work; // Adımı tutulmayan iş (daireler, gerçek modda katlar)
+    }
+
+    // Bileşim kalemleri
+    struct CriticalShare *sh = cp->shares;
+    for (int k = 0; k < JOB_KIND_COUNT; k++) {
+        for (int s = 0; s < job_programs[k].step_count; s++) {
+            if (step_time[price_item(k, s)] <= cp->epsilon) continue;
+            char label[64];
+            step_label(label, sizeof(label), k, s);
+            snprintf(sh->label, sizeof(sh->label), "%s: %s", job_kind_labels[k], label);
+            sh->time = step_time[price_item(k, s)];
+            (sh++)->resource = RES_NONE;
+        }
+        if (kind_time[k] > cp->epsilon) {
+            snprintf(sh->label, sizeof(sh->label), "%s işleri", job_kind_labels[k]);
+            sh->time = kind_time[k];
+            (sh++)->resource = RES_NONE;
+        }
+    }
+    for (int r = 0; r < RES_COUNT; r++) {
+        if (wait_time[r] <= cp->epsilon) continue;
+        snprintf(sh->label, sizeof(sh->label), "Bekleme: %s", resource_names[r]);
+        sh->time = wait_time[r];
+        (sh++)->resource = (enum ResourceId)r;
+    }
+    if (gaps > cp->epsilon) {
+        snprintf(sh->label, sizeof(sh->label), "Devir ve dağıtım gecikmesi");
+        sh->time = gaps;
+        (sh++)->resource = RES_NONE;
+    }
+    cp->share_count = (int)(sh - cp->shares);
+    qsort(cp->shares, cp->share_count, sizeof(struct CriticalShare), critical_share_compare);
+
+    free(order);
+    free(indegree);
+    free(late);
+    cp->analysis_ms = (monotonic_ns() - start) / 1e6;
+    return 1;
+}
+
+// Kritik yol raporunu yazdırır ve sonucu serbest bırakır
+void print_critical_path(struct CriticalPath *cp) {
+    const char *unit = run_mode == MODE_VIRTUAL ? "gün" : "sn";
+    printf(COLOR_CYAN "\n=== KRİTİK YOL VE BOLLUK (yürütülen programdan) ===\n" COLOR_RESET);
+    printf("Bitiş %.2f %s; kritik yolda %d iş; analiz %.2f ms\n", cp->makespan, unit, cp->path_length, cp->analysis_ms);
+
+    // Yol: aynı türden ardışık işler tek satırda (iç dizayn noktaları süresizdir, yazılmaz)
+    printf("Kritik yol                               | Başlangıç  | Süre       | Bekleme\n");
+    printf("-----------------------------------------|------------|------------|-----------\n");
+    for (int i = 0; i < cp->path_length;) {
+        int j = i;
+        double span = 0.0, wait = 0.0;
+        while (j < cp->path_length && cp->path_nodes[j].kind == cp->path_nodes[i].kind) {
+            span += cp->path_timing[j].span;
+            for (int r = 0; r < RES_COUNT; r++) wait += cp->path_timing[j].wait[r];
+            j++;
+        }
+        const struct GraphNode *first = &cp->path_nodes[i], *last = &cp->path_nodes[j - 1];
+        if (first->kind != JOB_INTERIOR) {
+            char label[96];
+            if (j - i > 1) {
+                snprintf(label, sizeof(label), "%s, kat %d-%d (%d iş)", job_kind_labels[first->kind], first->floor + 1,
+                         last->floor + 1, j - i);
+            } else if (first->apartment >= 0) {
+                snprintf(label, sizeof(label), "%s, kat %d daire %d", job_kind_labels[first->kind], first->floor + 1,
+                         first->apartment + 1);
+            } else if (first->floor >= 0) {
+                snprintf(label, sizeof(label), "%s, kat %d", job_kind_labels[first->kind], first->floor + 1);
+            } else {
+                snprintf(label, sizeof(label), "%s", job_kind_labels[first->kind]);
+            }
+            print_padded(label, 40);
+            double begin = cp->path_timing[i].finished - cp->path_timing[i].span;
+            printf(" | %10.2f | %10.2f | %10.2f\n", begin > 0.0 ? begin : 0.0, span, wait); // Kayan nokta payı
+        }
+        i = j;
+    }
+
+    char duration_header[32];
+    snprintf(duration_header, sizeof(duration_header), "Süre (%s)", unit);
+    printf("\nKritik yolun bileşimi                               | ");
+    print_padded(duration_header, 10);
+    printf(" | Pay\n");
+    printf("----------------------------------------------------|------------|-------\n");
+    for (int i = 0; i < cp->share_count; i++) {
+        print_padded(cp->shares[i].label, 51);
+        printf(" | %10.2f | %5.1f%%\n", cp->shares[i].time, cp->makespan > 0.0 ? 100.0 * cp->shares[i].time / cp->makespan : 0.0);
+    }
+
+    printf("\nİş türü                | Sayı     | Kritik   | En az bolluk | Ort. bolluk\n");
+    printf("-----------------------|----------|----------|--------------|------------\n");
+    for (int k = 0; k < JOB_KIND_COUNT; k++) {
+        const struct SlackSummary *s = &cp->kinds[k];
+        if (s->count == 0) continue;
+        print_padded(job_kind_labels[k], 22);
+        printf(" | %8ld | %8ld | %12.2f | %11.2f\n", s->count, s->critical, s->min, s->sum / s->count);
+    }
+    if (cp->nearest_slack >= 0.0) {
+        printf("İlk kritikleşecek iş: %s", job_kind_labels[cp->nearest.kind]);
+        if (cp->nearest.floor >= 0) printf(", kat %d", cp->nearest.floor + 1);
+        if (cp->nearest.apartment >= 0) printf(" daire %d", cp->nearest.apartment + 1);
+        printf(" (bolluk %.2f %s)\n", cp->nearest_slack, unit);
+    }
+    if (cp->share_count > 0) { // En büyük kalem: hızlandırılacak aşama ya da eklenecek ekip
+        const struct CriticalShare *top = &cp->shares[0];
+        double share = cp->makespan > 0.0 ? 100.0 * top->time / cp->makespan : 0.0;
+        if (top->resource != RES_NONE) {
+            printf("Önce hızlandırılacak: %s ekleyin (kritik yolda %.2f %s bekleme, bitişin %%%.1f payı)\n",
+                   resource_names[top->resource], top->time, unit, share);
+        } else {
+            printf("Önce hızlandırılacak: %s (kritik yolda %.2f %s, bitişin %%%.1f payı)\n", top->label, top->time, unit, share);
+        }
+    }
+    if (slack_path) printf("İş başına bolluk: %s\n", slack_path);
+    free(cp->path);
+    free(cp->path_nodes);
+    free(cp->path_timing);
+}
+
+// ---------------------------------------------------------------------------
+// İş çalma havuzu: donanım eşzamanlılığı kadar kalıcı işçi thread. Her işçinin kendi
+// Chase-Lev deque'i vardır; işi biten işçi önce kendi deque'inden alır, boşsa rastgele
+// bir işçiden çalar, o da boşsa dışarıdan gönderilen görevlerin kuyruğuna bakar.
+// ---------------------------------------------------------------------------
+
+#define POOL_DEQUE_SIZE 1024      // İşçi başına deque kapasitesi (2'nin kuvveti olmalı)
+
+// Havuz görevi; görev yapıları bu alanı ilk üye olarak gömer, bellek ayırma gerekmez
+struct PoolTask {
+    void (*run)(struct PoolTask *task);  // Görevi çalıştıran fonksiyon
+    struct PoolTask *next;               // Dış gönderim kuyruğundaki bağlantı
+};
+
+// Chase-Lev deque: sahibi alt uçtan ekler/alır, diğer işçiler üst uçtan çalar
+struct WorkDeque {
+    _Atomic long top __attribute__((aligned(CACHE_LINE)));     // Çalma ucu
+    _Atomic long bottom __attribute__((aligned(CACHE_LINE)));  // Sahip ucu
+    _Atomic(struct PoolTask *) buffer[POOL_DEQUE_SIZE];        // Görev işaretçileri
+};
+
+struct WorkerPool;
+
+// Havuzdaki bir işçi thread
+struct PoolWorker {
+    struct WorkDeque deque;    // İşçinin kendi deque'i
+    struct WorkerPool *pool;   // Ait olduğu havuz
+    int index;                 // İşçi numarası
+    unsigned int seed;         // Kurban seçimi için rastgele tohum
+    pthread_t thread;          // İşçi thread'i
+};
+
+// Havuz durumu
+struct WorkerPool {
+    struct PoolWorker *workers;          // İşçiler
+    int worker_count;                    // İşçi sayısı
+    pthread_mutex_t lock;                // Dış kuyruk ve uyku/uyandırma için kilit
+    pthread_cond_t wake;                 // Uyuyan işçileri uyandırmak için
+    pthread_cond_t idle;                 // Tüm görevler bitince pool_wait'i uyandırmak için
+    struct PoolTask *inject_head;        // Dışarıdan gönderilen görevler (FIFO)
+    struct PoolTask *inject_tail;
+    atomic_long pending;                 // Gönderilmiş ama bitmemiş görev sayısı
+    atomic_int sleepers;                 // Uyuyan işçi sayısı
+    int shutdown;                        // Kapatma isteği
+};
+
+static __thread struct PoolWorker *current_worker; // Bu thread bir havuz işçisiyse kendisi
+
+// Deque'in alt ucuna görev ekler (yalnızca sahibi çağırır); deque doluysa 0 döner
+static int deque_push(struct WorkDeque *d, struct PoolTask *task) {
+    long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - t >= POOL_DEQUE_SIZE) return 0;
+    atomic_store_explicit(&d->buffer[b & (POOL_DEQUE_SIZE - 1)], task, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    return 1;
+}
+
+// Deque'in alt ucundan görev alır (yalnızca sahibi çağırır)
+static struct PoolTask *deque_take(struct WorkDeque *d) {
+    long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+    struct PoolTask *task = NULL;
+    if (t <= b) {
+        task = atomic_load_explicit(&d->buffer[b & (POOL_DEQUE_SIZE - 1)], memory_order_relaxed);
+        if (t == b) { // Son görev: çalanlarla yarış
+            if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                         memory_order_seq_cst, memory_order_relaxed)) task = NULL;
+            atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        }
+    } else { // Deque boştu
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+// Deque'in üst ucundan görev çalar (herhangi bir thread çağırabilir)
+static struct PoolTask *deque_steal(struct WorkDeque *d) {
+    long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (t >= b) return NULL;
+    struct PoolTask *task = atomic_load_explicit(&d->buffer[t & (POOL_DEQUE_SIZE - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL; // Başka bir thread daha önce aldı
+    }
+    return task;
+}
+
+// Rastgele bir kurbandan başlayarak diğer işçilerden görev çalmayı dener
+static struct PoolTask *pool_steal(struct PoolWorker *self) {
+    struct WorkerPool *pool = self->pool;
+    int start = rand_r(&self->seed) % pool->worker_count;
+    for (int i = 0; i < pool->worker_count; i++) {
+        struct PoolWorker *victim = &pool->workers[(start + i) % pool->worker_count];
+        if (victim == self) continue;
+        struct PoolTask *task = deque_steal(&victim->deque);
+        if (task) return task;
+    }
+    return NULL;
+}
+
+// Dış kuyruktan görev alır (kilit tutulurken çağrılır)
+static struct PoolTask *pool_inject_pop_locked(struct WorkerPool *pool) {
+    struct PoolTask *task = pool->inject_head;
+    if (task) {
+        pool->inject_head = task->next;
+        if (!pool->inject_head) pool->inject_tail = NULL;
+    }
+    return task;
+}
+
+// Uyuyan bir işçi varsa uyandırır. Uyuyan sayısı kilit tutularak artırılır ve işçi beklerken kilidi
+// bırakır: sayacı sıfırdan büyük gören gönderici kilidi aldığında işçi ya hâlâ bakıyordur ya da
+// beklemededir, sinyal kaybolmaz.
+static void pool_wake_one(struct WorkerPool *pool) {
+    if (atomic_load(&pool->sleepers) == 0) return;
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Görevi havuza gönderir: işçi thread'inden çağrılırsa kendi deque'ine, değilse dış kuyruğa
+void pool_submit(struct WorkerPool *pool, struct PoolTask *task) {
+    atomic_fetch_add(&pool->pending, 1);
+    struct PoolWorker *self = current_worker;
+    if (self && self->pool == pool && deque_push(&self->deque, task)) {
+        // bottom yazımı uyuyan sayısının okunmasından önce görünmeli; karşı taraf uyumadan önce
+        // sayacı artırıp son kez çalar (pool_next_task). İki çit arasında en az biri diğerini görür.
+        atomic_thread_fence(memory_order_seq_cst);
+        pool_wake_one(pool); // Boştaki işçiler çalabilsin
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    task->next = NULL;
+    if (pool->inject_tail) pool->inject_tail->next = task;
+    else pool->inject_head = task;
+    pool->inject_tail = task;
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Sıradaki görevi bulur: kendi deque'i, diğer işçiler, dış kuyruk; hiçbiri yoksa uyur
+static struct PoolTask *pool_next_task(struct PoolWorker *self) {
+    struct WorkerPool *pool = self->pool;
+    for (;;) {
+        struct PoolTask *task = deque_take(&self->deque);
+        if (!task) task = pool_steal(self);
+        if (task) return task;
+
+        pthread_mutex_lock(&pool->lock);
+        task = pool_inject_pop_locked(pool);
+        if (task || pool->shutdown) {
+            pthread_mutex_unlock(&pool->lock);
+            return task; // Kapatılıyorsa NULL döner
+        }
+        atomic_fetch_add(&pool->sleepers, 1);
+        atomic_thread_fence(memory_order_seq_cst); // pool_submit'teki çitle eşleşir
+        task = pool_steal(self); // Uyumadan önce son kez bak (kaçırılan uyandırmaya karşı)
+        if (!task) pthread_cond_wait(&pool->wake, &pool->lock); // Gönderici kilidi alıp sinyal verir
+        atomic_fetch_sub(&pool->sleepers, 1);
+        pthread_mutex_unlock(&pool->lock);
+        if (task) return task;
+    }
+}
+
+// İşçi thread'inin ana döngüsü
+static void *pool_worker_main(void *arg) {
+    struct PoolWorker *self = arg;
+    struct WorkerPool *pool = self->pool;
+    current_worker = self;
+    trace_name(TRACE_NAME_WORKER, self->index);
+    struct PoolTask *task;
+    while ((task = pool_next_task(self)) != NULL) {
+        task->run(task);
+        if (atomic_fetch_sub(&pool->pending, 1) == 1) { // Son görev bitti
+            pthread_mutex_lock(&pool->lock);
+            pthread_cond_broadcast(&pool->idle);
+            pthread_mutex_unlock(&pool->lock);
+        }
+    }
+    return NULL;
+}
+
+// Havuzu oluşturur; worker_count <= 0 ise donanım eşzamanlılığı kadar işçi başlatır
+struct WorkerPool *pool_create(int worker_count) {
+    if (worker_count <= 0) worker_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (worker_count <= 0) worker_count = 1;
+    struct WorkerPool *pool = calloc(1, sizeof(struct WorkerPool));
+    void *workers = NULL;
+    if (!pool || posix_memalign(&workers, CACHE_LINE, worker_count * sizeof(struct PoolWorker)) != 0) {
+        perror("pool_create failed");
+        exit(EXIT_FAILURE);
+    }
+    memset(workers, 0, worker_count * sizeof(struct PoolWorker));
+    pool->workers = workers;
+    pool->worker_count = worker_count;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+    for (int i = 0; i < worker_count; i++) {
+        struct PoolWorker *w = &pool->workers[i];
+        w->pool = pool;
+        w->index = i;
+        w->seed = (unsigned int)(i * 2654435761u + 1);
+        pthread_create(&w->thread, NULL, pool_worker_main, w);
+    }
+    return pool;
+}
+
+// Gönderilen tüm görevler (ve onların gönderdiği devam görevleri) bitene kadar bekler
+void pool_wait(struct WorkerPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (atomic_load(&pool->pending) > 0) pthread_cond_wait(&pool->idle, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// İşçileri durdurur ve havuzu serbest bırakır
+void pool_destroy(struct WorkerPool *pool) {
+    pool_wait(pool);
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->worker_count; i++) pthread_join(pool->workers[i].thread, NULL);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->idle);
+    free(pool->workers);
+    free(pool);
+}
+
+// ---------------------------------------------------------------------------
+// Askıya alınan havuz görevleri: gerçek modda bekleyen bir adım işçi thread'ini tutmaz.
+// Gecikme bekleyen görev zamanlayıcı thread'in yığınına, meşgul kaynağı bekleyen görev
+// kaynağın kuyruğuna girer; süre dolunca ya da ekip devredilince görev yeniden havuza
+// gönderilir. Askıdaki bir daire yalnızca görev yapısı ve yığın girdisi kadar yer tutar.
+// ---------------------------------------------------------------------------
+
+// Zamanlayıcı yığınındaki girdi
+struct TimerEntry {
+    uint64_t due;           // Uyanma anı (monotonic_ns)
+    struct PoolTask *task;  // Süre dolunca havuza gönderilecek görev
+};
+
+// Zamanlayıcı: uyanma anına göre ikili min-yığın ve onu boşaltan tek thread
+struct TaskTimer {
+    struct WorkerPool *pool;   // Uyanan görevlerin gönderileceği havuz
+    pthread_t thread;          // Zamanlayıcı thread'i
+    pthread_mutex_t lock;      // Yığını korur
+    pthread_cond_t wake;       // Yeni en erken girdi ya da kapatma (CLOCK_MONOTONIC)
+    struct TimerEntry *heap;   // Girdiler
+    long count, capacity;      // Girdi sayısı ve ayrılan yer
+    int shutdown;              // Kapatma isteği
+};
+
+// Kaynağı bekleyen görevler (FIFO); kilit, semaforun boşa çıkmasıyla kuyruğa girmeyi sıralar
+struct ResourceQueue {
+    pthread_mutex_t lock;
+    struct PoolTask *head, *tail;
+};
+
+static struct ResourceQueue resource_queues[RES_COUNT] = {
+    { PTHREAD_MUTEX_INITIALIZER, NULL, NULL }, { PTHREAD_MUTEX_INITIALIZER, NULL, NULL },
+    { PTHREAD_MUTEX_INITIALIZER, NULL, NULL }, { PTHREAD_MUTEX_INITIALIZER, NULL, NULL },
+};
+
+// Zamanlayıcı thread'i: süresi dolan görevleri toplu olarak havuza gönderir
+static void *task_timer_main(void *arg) {
+    struct TaskTimer *timer = arg;
+    struct PoolTask *due[64];
+    pthread_mutex_lock(&timer->lock);
+    while (!timer->shutdown || timer->count > 0) {
+        if (timer->count == 0) {
+            pthread_cond_wait(&timer->wake, &timer->lock);
+            continue;
+        }
+        uint64_t now = monotonic_ns();
+        if (timer->heap[0].due > now) {
+            struct timespec until = { (time_t)(timer->heap[0].due / 1000000000ULL), (long)(timer->heap[0].due % 1000000000ULL) };
+            pthread_cond_timedwait(&timer->wake, &timer->lock, &until);
+            continue;
+        }
+        int n = 0;
+        while (n < 64 && timer->count > 0 && timer->heap[0].due <= now) { // En erken girdiyi çıkar ve yığını onar
+            due[n++] = timer->heap[0].task;
+            struct TimerEntry last = timer->heap[--timer->count];
+            long i = 0;
+            for (;;) {
+                long c = 2 * i + 1;
+                if (c >= timer->count) break;
+                if (c + 1 < timer->count && timer->heap[c + 1].due < timer->heap[c].due) c++;
+                if (timer->heap[c].due >= last.due) break;
+                timer->heap[i] = timer->heap[c];
+                i = c;
+            }
+            if (timer->count > 0) timer->heap[i] = last;
+        }
+        pthread_mutex_unlock(&timer->lock);
+        for (int i = 0; i < n; i++) pool_submit(timer->pool, due[i]);
+        pthread_mutex_lock(&timer->lock);
+    }
+    pthread_mutex_unlock(&timer->lock);
+    return NULL;
+}
+
+// Zamanlayıcıyı başlatır; capacity, aynı anda askıda olabilecek görev sayısı için ilk tahmindir
+struct TaskTimer *task_timer_start(struct WorkerPool *pool, long capacity) {
+    struct TaskTimer *timer = calloc(1, sizeof(struct TaskTimer));
+    if (capacity < 64) capacity = 64;
+    if (timer) timer->heap = malloc(capacity * sizeof(struct TimerEntry));
+    if (!timer || !timer->heap) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    timer->pool = pool;
+    timer->capacity = capacity;
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC); // Uyanma anları monotonic_ns ile aynı saatte
+    pthread_cond_init(&timer->wake, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    pthread_mutex_init(&timer->lock, NULL);
+    pthread_create(&timer->thread, NULL, task_timer_main, timer);
+    return timer;
+}
+
+// Görevi due anında havuza gönderilmek üzere askıya alır
+void task_timer_add(struct TaskTimer *timer, struct PoolTask *task, uint64_t due) {
+    pthread_mutex_lock(&timer->lock);
+    if (timer->count == timer->capacity) {
+        struct TimerEntry *grown = realloc(timer->heap, 2 * timer->capacity * sizeof(struct TimerEntry));
+        if (!grown) {
+            perror("realloc failed");
+            exit(EXIT_FAILURE);
+        }
+        timer->heap = grown;
+        timer->capacity *= 2;
+    }
+    long i = timer->count++;
+    while (i > 0 && timer->heap[(i - 1) / 2].due > due) { // Yukarı kaydır
+        timer->heap[i] = timer->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    timer->heap[i] = (struct TimerEntry){ due, task };
+    if (i == 0) pthread_cond_signal(&timer->wake); // Yeni en erken girdi: thread'in bekleme süresi kısalır
+    pthread_mutex_unlock(&timer->lock);
+}
+
+// Kalan girdileri gönderip zamanlayıcıyı durdurur
+void task_timer_stop(struct TaskTimer *timer) {
+    pthread_mutex_lock(&timer->lock);
+    timer->shutdown = 1;
+    pthread_cond_signal(&timer->wake);
+    pthread_mutex_unlock(&timer->lock);
+    pthread_join(timer->thread, NULL);
+    pthread_mutex_destroy(&timer->lock);
+    pthread_cond_destroy(&timer->wake);
+    free(timer->heap);
+    free(timer);
+}
+
+// Kaynaktan beklemeden bir ekip almayı dener; tüm ekipler meşgulse görevi kaynağın kuyruğuna
+// koyar ve 0 döner. Kuyruktaki görev, ekip ona devredildiğinde havuza yeniden gönderilir.
+int resource_acquire_or_queue(enum ResourceId res, struct PoolTask *task) {
+    struct ResourceQueue *q = &resource_queues[res];
+    pthread_mutex_lock(&q->lock);
+    int acquired = q->head == NULL && sem_trywait(&resource_sem[res]) == 0; // Kuyruk varsa sıraya gir
+    if (!acquired) {
+        task->next = NULL;
+        if (q->tail) q->tail->next = task;
+        else q->head = task;
+        q->tail = task;
+    }
+    atomic_fetch_add_explicit(acquired ? &live_busy[res] : &live_queued[res], 1, memory_order_relaxed); // Canlı ölçümler
+    pthread_mutex_unlock(&q->lock);
+    return acquired;
+}
+
+// Ekibi bırakır: bekleyen görev varsa ekip doğrudan ona devredilir, yoksa semafora döner
+void resource_release_to_queue(enum ResourceId res, struct WorkerPool *pool) {
+    struct ResourceQueue *q = &resource_queues[res];
+    pthread_mutex_lock(&q->lock);
+    struct PoolTask *next = q->head;
+    if (next) {
+        q->head = next->next;
+        if (!q->head) q->tail = NULL;
+    } else {
+        sem_post(&resource_sem[res]);
+    }
+    atomic_fetch_sub_explicit(next ? &live_queued[res] : &live_busy[res], 1, memory_order_relaxed); // Canlı ölçümler
+    pthread_mutex_unlock(&q->lock);
+    if (next) pool_submit(pool, next);
+}
+
+// Kat bildirimleri: kat süreçleri bittiklerini paylaşılan eşlemedeki posta kutusuyla ana sürece
+// bildirir. Gönderen yuvayı doldurup sayacı yayınlar, okuyucu kısa bir süre döndükten sonra
+// sayaç üzerinde futex ile uyur; çekirdeğe yalnızca gerçekten uyuyan biri varsa gidilir.
+#define MAILBOX_SPINS 4000  // Futex'e düşmeden önce sayacı yoklama sayısı (çok çekirdekte ~birkaç µs)
+
+static int mailbox_spins = -1;      // Bekleyenin dönme sınırı (-1: ilk beklemede çekirdek sayısına göre seçilir)
+struct Histogram floor_handoff_hist; // Gönderimden ana sürecin bildirimi almasına kadar geçen süre (ns)
+double floor_reported_cost;         // Kat süreçlerinin bildirdiği maliyetlerin toplamı
+long floor_retries;                 // Süreci çöktüğü için yeniden kuyruğa alınan kat sayısı
+
+// Paylaşılan (süreçler arası) futex çağrısı; timeout NULL ise süresiz bekler
+static long futex(_Atomic uint32_t *word, int op, uint32_t value, const struct timespec *timeout) {
+    return syscall(SYS_futex, (uint32_t *)word, op, value, timeout, NULL, 0);
+}
+
+// Döngüde beklerken işlemciye bekleme ipucu verir
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Sayaç hâlâ seen ise futex üzerinde en fazla deadline anına kadar uyur (deadline 0: süresiz).
+// Süre dolduysa -1, aksi halde 0 döner.
+static int futex_sleep(_Atomic uint32_t *word, _Atomic uint32_t *waiters, uint32_t seen, uint64_t deadline) {
+    struct timespec ts, *timeout = NULL;
+    if (deadline) {
+        uint64_t now = monotonic_ns();
+        if (now >= deadline) return -1;
+        ts.tv_sec = (time_t)((deadline - now) / 1000000000ULL);
+        ts.tv_nsec = (long)((deadline - now) % 1000000000ULL);
+        timeout = &ts;
+    }
+    atomic_fetch_add(waiters, 1);
+    // Yazar sayacı artırdıktan sonra waiters'ı okur: sayaç değiştiyse çekirdek hemen döner, uyandırma kaçmaz
+    futex(word, FUTEX_WAIT, seen, timeout);
+    atomic_fetch_sub(waiters, 1);
+    return 0;
+}
+
+// Futex sözcüğünde uyuyan varsa uyandırır
+static void futex_wake(_Atomic uint32_t *word, _Atomic uint32_t *waiters, int count) {
+    if (atomic_load(waiters) > 0) futex(word, FUTEX_WAKE, (uint32_t)count, NULL);
+}
+
+// Posta kutusunu boşaltır (yalnızca kimse yazmıyor ve beklemiyorken)
+void mailbox_reset(struct Mailbox *mb) {
+    for (int i = 0; i < MAILBOX_SLOTS; i++) atomic_store(&mb->slots[i].seq, 0);
+    atomic_store(&mb->reserved, 0);
+    atomic_store(&mb->posted, 0);
+    atomic_store(&mb->waiters, 0);
+}
+
+// Mesajı sıradaki numarayla yayınlar ve uyuyan okuyucu varsa uyandırır
+void mailbox_post(struct Mailbox *mb, const struct FloorMessage *msg) {
+    uint64_t start = trace_now();
+    uint32_t index = atomic_fetch_add(&mb->reserved, 1);
+    struct MailSlot *slot = &mb->slots[index & (MAILBOX_SLOTS - 1)];
+    slot->msg = *msg;
+    atomic_store_explicit(&slot->seq, index + 1, memory_order_release);
+    atomic_fetch_add(&mb->posted, 1);
+    futex_wake(&mb->posted, &mb->waiters, INT_MAX);
+    trace_span(TRACE_MAIL_POST, 0, msg->floor, -1, start, 's', (uint32_t)msg->floor + 1, -1); // Akış bekleyen ana sürece gider
+}
+
+// index numaralı mesajı bekler. timeout_ms < 0 ise süresiz, 0 ise beklemeden bakar; mesaj
+// geldiyse 0, süre dolduysa -1 döner.
+int mailbox_wait(struct Mailbox *mb, uint32_t index, struct FloorMessage *msg, int timeout_ms) {
+    if (mailbox_spins < 0) mailbox_spins = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? MAILBOX_SPINS : 0; // Tek çekirdekte dönmek gönderenin zamanını çalar
+    uint64_t start = trace_now();
+    uint64_t deadline = timeout_ms > 0 ? monotonic_ns() + (uint64_t)timeout_ms * 1000000ULL : 0;
+    struct MailSlot *slot = &mb->slots[index & (MAILBOX_SLOTS - 1)];
+    for (int spin = 0; atomic_load_explicit(&slot->seq, memory_order_acquire) != index + 1; spin++) {
+        if (timeout_ms == 0) return -1;
+        if (spin < mailbox_spins) {
+            cpu_relax();
+            continue;
+        }
+        uint32_t seen = atomic_load(&mb->posted);
+        if (atomic_load(&slot->seq) == index + 1) break;
+        if (futex_sleep(&mb->posted, &mb->waiters, seen, deadline) < 0) return -1;
+    }
+    *msg = slot->msg;
+    trace_span(TRACE_MAIL_WAIT, 0, msg->floor, -1, start, 'f', (uint32_t)msg->floor + 1, -1);
+    return 0;
+}
+
+// Kat işi kuyruğunu boşaltır
+void floor_queue_reset(struct FloorQueue *q) {
+    atomic_store(&q->pushed, 0);
+    atomic_store(&q->popped, 0);
+    atomic_store(&q->waiters, 0);
+}
+
+// Katı (ya da çıkış işareti olarak -1'i) kuyruğa koyar; yalnızca ana süreç çağırır
+void floor_queue_push(struct FloorQueue *q, int floor) {
+    uint32_t pushed = atomic_load_explicit(&q->pushed, memory_order_relaxed);
+    atomic_store_explicit(&q->slots[pushed & (FLOOR_QUEUE_SLOTS - 1)], floor, memory_order_relaxed);
+    atomic_store(&q->pushed, pushed + 1);
+    futex_wake(&q->pushed, &q->waiters, 1);
+}
+
+// Kuyruktan sıradaki işi alır; kuyruk boşsa futex üzerinde uyur
+int floor_queue_pop(struct FloorQueue *q) {
+    for (;;) {
+        uint32_t popped = atomic_load(&q->popped);
+        uint32_t pushed = atomic_load(&q->pushed);
+        if (popped == pushed) {
+            futex_sleep(&q->pushed, &q->waiters, pushed, 0);
+            continue;
+        }
+        int floor = atomic_load(&q->slots[popped & (FLOOR_QUEUE_SLOTS - 1)]); // CAS'tan önce oku: yuva sonra yeniden kullanılabilir
+        if (atomic_compare_exchange_weak(&q->popped, &popped, popped + 1)) return floor;
+    }
+}
+
+// Kat inşaatı fonksiyonu (kaba inşaat ve ortak alanlar); kat süreçlerinde çalışır. Maliyetler
+// bildirimde birikir: süreç bildirmeden ölürse deneme deftere hiçbir şey yazmamış olur ve
+// süreç maliyet dilimi de tutmaz.
+void floor_construction(int floor) {
+    struct FloorMessage msg = { .floor = floor, .status = 0 };
+    floor_pending = &msg;
+    run_job(JOB_FLOOR, floor, -1); // Temel yapı, kolon ve kirişler, duvarlar, koridor ve merdivenler
+    floor_pending = NULL;
+
+    int32_t crash = floor;
+    if (atomic_compare_exchange_strong(&shared_data->crash_floor, &crash, -1)) raise(SIGKILL); // Hata enjeksiyonu
+
+    // Ana süreci uyandır: sıradaki kat ve bu katın daireleri başlayabilir
+    log_message(MSG_FLOOR_SIGNAL, floor+1, 0);
+    msg.posted_ns = monotonic_ns();
+    mailbox_post(&shared_data->floor_mail, &msg);
+}
+
+// Kalıcı kat işçileri (--floor-procs=N): süreçler bir kez fork edilir, paylaşılan eşlemeye zaten
+// bağlıdır ve katları kat işi kuyruğundan alır. Çöken işçi yeniden başlatılır ve katı yeniden
+// kuyruğa alınır. NULL ise her kat için ayrı süreç fork edilir.
+struct FloorProcs {
+    int count;    // İşçi süreç sayısı
+    pid_t *pids;  // Yuva başına işçinin PID'i
+};
+
+int floor_procs;  // --floor-procs ile istenen kalıcı kat işçisi sayısı (0: kat başına fork)
+
+// Kalıcı kat işçisinin döngüsü: çıkış işaretine kadar kuyruktan kat alıp inşa eder
+static void floor_worker_main(int slot) {
+    trace_name(TRACE_NAME_FLOOR_WORKER, slot); // İzde süreci yuvasıyla adlandır
+    for (;;) {
+        int floor = floor_queue_pop(&shared_data->floor_work);
+        if (floor < 0) break;
+        atomic_store(&shared_data->floor_worker_job[slot], floor); // Çökerse ana süreç katı buradan bulur
+        floor_construction(floor);
+        atomic_store(&shared_data->floor_worker_job[slot], -1);    // Bildirimden sonra: bildirilen kat yeniden kuyruğa alınmaz
+    }
+    _exit(0);
+}
+
+// Yuvadaki kalıcı kat işçisini fork eder
+static void floor_worker_spawn(struct FloorProcs *procs, int slot) {
+    atomic_store(&shared_data->floor_worker_job[slot], -1);
+    pid_t pid = fork();
+    if (pid == 0) floor_worker_main(slot);
+    else if (pid < 0) {
+        perror("fork hatası");
+        exit(EXIT_FAILURE);
+    }
+    procs->pids[slot] = pid;
+}
+
+// Kalıcı kat işçilerini başlatır (iz alanı eşlendikten sonra çağrılmalı)
+struct FloorProcs *floor_procs_create(int count) {
+    struct FloorProcs *procs = malloc(sizeof(struct FloorProcs));
+    if (procs) procs->pids = calloc(count, sizeof(pid_t));
+    if (!procs || !procs->pids) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    procs->count = count;
+    floor_queue_reset(&shared_data->floor_work);
+    for (int w = 0; w < count; w++) floor_worker_spawn(procs, w);
+    return procs;
+}
+
+// İşçilere çıkmalarını söyler ve hepsinin bitmesini bekler
+void floor_procs_destroy(struct FloorProcs *procs) {
+    for (int w = 0; w < procs->count; w++) floor_queue_push(&shared_data->floor_work, -1);
+    for (int w = 0; w < procs->count; w++) waitpid(procs->pids[w], NULL, 0);
+    free(procs->pids);
+    free(procs);
+}
+
+struct GraphExecutor;
+
+// Adımın askıya alınabildiği noktalar: görev her devam edişinde kaldığı aşamadan sürer
+enum StepPhase {
+    STEP_ACQUIRE,   // Adım başlıyor: kaynağı al (meşgulse kaynağın kuyruğunda askıya alınır)
+    STEP_GRANTED,   // Kuyrukta beklerken ekip devredildi
+    STEP_FINISH     // Gecikme doldu: adımı bitir, kaynağı bırak, maliyeti ekle
+};
+
+// Gerçek modda bir graf düğümü; adımları sırayla, bekleme noktalarında askıya alınan
+// durum makinesi olarak havuz görevlerinde çalışır (iş parçacığı yığını tutmaz)
+struct NodeTask {
+    struct PoolTask task;          // Havuz görevi (ilk üye)
+    struct GraphExecutor *exec;    // Ait olduğu yürütücü
+    int node;                      // Düğüm indeksi
+    uint8_t step;                  // Sıradaki adım
+    uint8_t phase;                 // Adımın aşaması (enum StepPhase)
+    uint64_t mark;                 // Kuyruğa girme, sonra kaynağı alma anı (ns)
+};
+
+// ---------------------------------------------------------------------------
+// Malzeme taşıma: mutfak malzemesi isteyen daireler kuyrukta bekler. Boşa çıkan asansör
+// kuyruğun en eski isteğinin katını ve ona en yakın katları kapasitesi kadar toplayıp tek
+// seferde taşır; sefer süresi en üst durağa uzaklığa ve durak sayısına bağlıdır. Kuyruk
+// merdivenle taşımayı daha kısa gösterecek kadar uzunsa istek merdivenden gider. Kabinde
+// yer varken asansör, en eski istek --delivery-hold kadar bekleyene dek kalkmayabilir.
+// Tek tek taşıma aynı sefer modelini kapasite 1 ile, merdivensiz ve bekletmesiz kullanır;
+// iki politikanın farkı yalnızca kuyruk kuralıdır. Politika her iki modda aynıdır; sanal
+// mod olay kuyruğunda, gerçek mod zamanlayıcıda uygular.
+// ---------------------------------------------------------------------------
+
+// Adım asansörle taşıma mı (asansörü ekip gibi tutmaz, seferle taşınır)
+static inline int step_elevator_delivery(const struct TaskStep *step) {
+    return step->resource == RES_ELEVATOR;
+}
+
+// Bir seferde taşınan daire malzemesi sınırı
+static inline int delivery_capacity(void) {
+    return delivery_mode == DELIVERY_BATCH ? elevator_capacity : 1;
+}
+
+// Kabinde yer varken boş asansörün en eski isteği bekletebileceği süre
+static inline double delivery_hold_days(void) {
+    return delivery_mode == DELIVERY_BATCH ? delivery_hold : 0.0;
+}
+
+// Bir dairenin malzemesini merdivenle taşıma süresi: kat yükseldikçe uzar
+static double stairs_days(int floor) {
+    return STAIRS_BASE_DAYS + (floor + 1) * STAIRS_FLOOR_DAYS;
+}
+
+// Asansörle taşımanın tahmini süresi merdivenden uzunsa merdiveni seçer. Tahmin, kuyruktakilerin
+// dolduracağı seferler, tüm asansörler meşgulse süren seferin yarısı ve isteğin kendi teslimidir.
+static int delivery_use_stairs(int floor, int queued, int busy, int elevators) {
+    if (delivery_mode == DELIVERY_SINGLE) return 0;
+    double full_trip = ELEVATOR_LOAD_DAYS * elevator_capacity + (total_floors + 2) * ELEVATOR_FLOOR_DAYS +
+                       elevator_capacity * ELEVATOR_STOP_DAYS; // Binanın ortasına kadar dolu bir sefer
+    double rounds = (double)(queued / (elevator_capacity * elevators)) + (busy >= elevators ? 0.5 : 0.0);
+    double own = ELEVATOR_LOAD_DAYS + (floor + 1) * ELEVATOR_FLOOR_DAYS + ELEVATOR_STOP_DAYS;
+    return stairs_days(floor) < rounds * full_trip + own;
+}
+
+// Kuyruğun en eski count isteğinden (floors kuyruk sırasıyla katlar) bir sefer seçer: en eski
+// isteğin katındakiler önce, sonra o kata en yakın katlardakiler; eşitlikte kuyruk sırası.
+// Seçilen konumları kata göre artan sırada picked'a yazar ve sayısını döndürür.
+static int delivery_pick(const int *floors, int count, int *picked) {
+    char taken[DELIVERY_WINDOW] = { 0 };
+    int n = 0;
+    while (n < delivery_capacity() && n < count) {
+        int best = -1;
+        for (int i = 0; i < count; i++) {
+            if (!taken[i] && (best < 0 || abs(floors[i] - floors[0]) < abs(floors[best] - floors[0]))) best = i;
+        }
+        taken[best] = 1;
+        int k = n++;
+        while (k > 0 && floors[picked[k - 1]] > floors[best]) { // Durak sırası: alttan üste
+            picked[k] = picked[k - 1];
+            k--;
+        }
+        picked[k] = best;
+    }
+    return n;
+}
+
+// Artan sıralı katlara uğrayan seferin süresini döndürür: yükleme, en üst durağa çıkış ve
+// dönüş, her farklı katta bir duruş. arrive[i], i. malzemenin sefer başından teslim anıdır.
+static double delivery_trip(const int *floors, int n, double *arrive) {
+    double load = ELEVATOR_LOAD_DAYS * n;
+    int stops = 0;
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || floors[i] != floors[i - 1]) stops++;
+        arrive[i] = load + (floors[i] + 1) * ELEVATOR_FLOOR_DAYS + stops * ELEVATOR_STOP_DAYS;
+    }
+    return load + 2 * (floors[n - 1] + 1) * ELEVATOR_FLOOR_DAYS + stops * ELEVATOR_STOP_DAYS;
+}
+
+// Gerçek modda asansörün dönüşünü (ya da bekletmenin bitişini) bekleyen görev
+struct DeliveryTrip {
+    struct PoolTask task;          // Zamanlayıcıdan dönüşte çalışan görev (ilk üye)
+    struct GraphExecutor *exec;    // Ait olduğu yürütücü
+};
+
+// Gerçek modda taşıma masası: bekleyen daire görevleri ve boştaki asansörler
+struct DeliveryDesk {
+    pthread_mutex_t lock;              // Kuyruğu ve asansörleri korur
+    struct NodeTask *head, *tail;      // Bekleyen görevler (task.next ile bağlı, FIFO)
+    int queued;                        // Bekleyen görev sayısı
+    int busy;                          // Seferdeki asansör sayısı
+    int idle_count;                    // Boştaki asansör sayısı
+    int idle[MAX_CREWS];               // Boştaki asansörlerin numaraları
+    struct DeliveryTrip trips[MAX_CREWS]; // Asansör başına dönüş görevi
+    struct DeliveryTrip hold;          // Bekletmenin bitişinde kuyruğa yeniden bakan görev
+    int hold_armed;                    // Bekletme görevi zamanlayıcıda
+};
+
+// Gerçek zamanlı graf yürütücüsü: katlar ana süreçte fork ile, diğer düğümler havuzda çalışır
+struct GraphExecutor {
+    const struct TaskGraph *graph; // Bağımlılık grafı
+    struct WorkerPool *pool;       // Daire, temel ve çatı adımlarının çalıştığı havuz
+    struct TaskTimer *timer;       // Gecikme bekleyen adımları uyandıran zamanlayıcı
+    struct NodeTask *tasks;        // Düğüm başına havuz görevi
+    atomic_int *remaining;         // Düğüm başına bitmemiş öncül sayısı
+    atomic_int nodes_left;         // Bitmemiş düğüm sayısı
+    pthread_mutex_t lock;          // Kat kuyruğunu korur
+    pthread_cond_t ready;          // Kat hazır oldu ya da tüm düğümler bitti
+    int *floor_queue;              // Ana sürecin dağıtacağı hazır katlar (FIFO)
+    int queue_head, queue_tail;    // Kuyruğun okuma ve yazma konumları
+    struct FloorProcs *procs;      // Kalıcı kat işçileri (NULL: kat başına fork)
+    pid_t *floor_pid;              // Kat başına fork modunda katı inşa eden süreç (0: yok)
+    char *floor_done;              // Bildirimi alınan katlar
+    int *floor_attempts;           // Kat başına dağıtım sayısı
+    int floors_running;            // Dağıtılıp bildirimi beklenen kat sayısı
+    uint32_t floor_messages;       // Okunan bildirim sayısı (sıradaki posta kutusu numarası)
+    struct DeliveryDesk delivery;  // Toplu malzeme taşıma (--deliveries=batch)
+};
+
+// Öncülleri biten düğümü çalışmaya gönderir; driver düğümü serbest bırakan son öncüldür (-1: öncülü yok)
+static void executor_release(struct GraphExecutor *ex, int node, int driver) {
+    const struct GraphNode *n = &ex->graph->nodes[node];
+    graph_node_released(n);
+    schedule_released(node, driver);
+    if (n->kind == JOB_FLOOR) { // Katlar ayrı süreçte çalışır: fork'u ana süreç yapar
+        pthread_mutex_lock(&ex->lock);
+        ex->floor_queue[ex->queue_tail++] = node;
+        pthread_cond_signal(&ex->ready);
+        pthread_mutex_unlock(&ex->lock);
+        return;
+    }
+    pool_submit(ex->pool, &ex->tasks[node].task);
+}
+
+// Biten düğümün ardıllarının sayaçlarını azaltır; sayacı sıfırlanan ardıl hemen serbest kalır
+static void executor_complete(struct GraphExecutor *ex, int node) {
+    const struct TaskGraph *g = ex->graph;
+    schedule_finished(node);
+    graph_node_finished(&g->nodes[node]);
+    for (int e = g->succ_start[node]; e < g->succ_start[node + 1]; e++) {
+        int next = g->succ[e];
+        if (atomic_fetch_sub(&ex->remaining[next], 1) == 1) executor_release(ex, next, node);
+    }
+    if (atomic_fetch_sub(&ex->nodes_left, 1) == 1) { // Son düğüm: ana süreci uyandır
+        pthread_mutex_lock(&ex->lock);
+        pthread_cond_broadcast(&ex->ready);
+        pthread_mutex_unlock(&ex->lock);
+    }
+}
+
+// Kuyruktaki en eski isteklerden bir sefer kurar: seçilen görevler kendi katlarına varış anında,
+// asansör de dönüşünde zamanlayıcıdan uyanır. Masa kilidi tutulurken ve boş asansör varken çağrılır.
+// fresh, kuyruğa az önce girip boş asansöre hemen binen istektir (beklemedi; NULL: yok).
+static void delivery_trip_locked(struct GraphExecutor *ex, struct NodeTask *fresh) {
+    struct DeliveryDesk *desk = &ex->delivery;
+    struct NodeTask *window[DELIVERY_WINDOW];
+    int floors[DELIVERY_WINDOW] = { 0 }, count = 0;
+    for (struct NodeTask *t = desk->head; t && count < DELIVERY_WINDOW; t = (struct NodeTask *)t->task.next) {
+        window[count] = t;
+        floors[count++] = ex->graph->nodes[t->node].floor;
+    }
+    int picked[MAX_ELEVATOR_CAPACITY], batch_floors[MAX_ELEVATOR_CAPACITY];
+    int n = delivery_pick(floors, count, picked);
+    char chosen[DELIVERY_WINDOW] = { 0 };
+    for (int i = 0; i < n; i++) {
+        chosen[picked[i]] = 1;
+        batch_floors[i] = floors[picked[i]];
+    }
+    struct NodeTask *prev = NULL; // Seçilenleri kuyruktan çıkar
+    for (int i = 0; i < count; i++) {
+        struct NodeTask *next = (struct NodeTask *)window[i]->task.next;
+        if (!chosen[i]) {
+            prev = window[i];
+            continue;
+        }
+        if (prev) prev->task.next = (struct PoolTask *)next;
+        else desk->head = next;
+        if (desk->tail == window[i]) desk->tail = prev;
+    }
+    desk->queued -= n;
+    desk->busy++;
+    struct DeliveryTrip *trip = &desk->trips[desk->idle[--desk->idle_count]];
+
+    double arrive[MAX_ELEVATOR_CAPACITY];
+    double trip_days = delivery_trip(batch_floors, n, arrive);
+    uint64_t now = monotonic_ns();
+    for (int i = 0; i < n; i++) {
+        struct NodeTask *t = window[picked[i]];
+        const struct GraphNode *node = &ex->graph->nodes[t->node];
+        int contended = t != fresh;
+        resource_stats_wait(RES_ELEVATOR, contended ? now - t->mark : 0, contended);
+        if (contended) schedule_waited(t->node, RES_ELEVATOR, (now - t->mark) / 1e9);
+        schedule_step(t->node, t->step, arrive[i] * delay_scale);
+        trace_async(TRACE_RESOURCE_WAIT, RES_ELEVATOR, node->floor, node->apartment, t->mark - trace_epoch, (uint32_t)t->node + 1);
+        log_step(node->kind, node->floor, node->apartment, t->step, 0);
+        task_timer_add(ex->timer, &t->task, now + (uint64_t)(arrive[i] * delay_scale * 1e9));
+    }
+    uint64_t trip_ns = (uint64_t)(trip_days * delay_scale * 1e9);
+    resource_stats_hold(RES_ELEVATOR, trip_ns);
+    task_timer_add(ex->timer, &trip->task, now + trip_ns);
+}
+
+// Boş asansör ve kalkmaya hazır sefer oldukça sefer kurar. Sefer, kabin dolacak kadar istek
+// varsa ya da en eski istek bekletme süresini doldurduysa hazırdır; değilse bekletmenin bitişine
+// zamanlayıcı kurulur. Masa kilidi tutulurken çağrılır.
+static void delivery_dispatch_locked(struct GraphExecutor *ex, struct NodeTask *fresh) {
+    struct DeliveryDesk *desk = &ex->delivery;
+    uint64_t hold_ns = (uint64_t)(delivery_hold_days() * delay_scale * 1e9);
+    while (desk->idle_count > 0 && desk->head) {
+        if (desk->queued < delivery_capacity() && monotonic_ns() < desk->head->mark + hold_ns) {
+            if (!desk->hold_armed) {
+                desk->hold_armed = 1;
+                task_timer_add(ex->timer, &desk->hold.task, desk->head->mark + hold_ns);
+            }
+            break;
+        }
+        delivery_trip_locked(ex, fresh);
+    }
+    atomic_store_explicit(&live_busy[RES_ELEVATOR], desk->busy, memory_order_relaxed);
+    atomic_store_explicit(&live_queued[RES_ELEVATOR], desk->queued, memory_order_relaxed);
+}
+
+// Asansör döndü: kuyrukta hazır sefer varsa hemen yeni sefere çıkar
+static void delivery_return_task(struct PoolTask *task) {
+    struct DeliveryTrip *trip = (struct DeliveryTrip *)task;
+    struct GraphExecutor *ex = trip->exec;
+    struct DeliveryDesk *desk = &ex->delivery;
+    pthread_mutex_lock(&desk->lock);
+    desk->busy--;
+    desk->idle[desk->idle_count++] = (int)(trip - desk->trips);
+    delivery_dispatch_locked(ex, NULL);
+    pthread_mutex_unlock(&desk->lock);
+}
+
+// Bekletme bitti: en eski istek hâlâ bekliyorsa sefer kurulur (kuyruk değiştiyse yeniden kurulur)
+static void delivery_hold_task(struct PoolTask *task) {
+    struct GraphExecutor *ex = ((struct DeliveryTrip *)task)->exec;
+    struct DeliveryDesk *desk = &ex->delivery;
+    pthread_mutex_lock(&desk->lock);
+    desk->hold_armed = 0;
+    delivery_dispatch_locked(ex, NULL);
+    pthread_mutex_unlock(&desk->lock);
+}
+
+// Daire görevinin malzeme isteği: ya merdivenle taşınır ya da kuyruğa girer (boş asansör varsa
+// sefer hemen kurulur). Görev her iki durumda da teslim anında zamanlayıcıdan döner.
+static void delivery_request(struct GraphExecutor *ex, struct NodeTask *t) {
+    struct DeliveryDesk *desk = &ex->delivery;
+    const struct GraphNode *node = &ex->graph->nodes[t->node];
+    pthread_mutex_lock(&desk->lock);
+    if (delivery_use_stairs(node->floor, desk->queued, desk->busy, desk->busy + desk->idle_count)) {
+        pthread_mutex_unlock(&desk->lock);
+        log_step(node->kind, node->floor, node->apartment, t->step, 0);
+        schedule_step(t->node, t->step, stairs_days(node->floor) * delay_scale);
+        task_timer_add(ex->timer, &t->task, monotonic_ns() + (uint64_t)(stairs_days(node->floor) * delay_scale * 1e9));
+        return;
+    }
+    t->mark = monotonic_ns();
+    t->task.next = NULL;
+    if (desk->tail) desk->tail->task.next = &t->task;
+    else desk->head = t;
+    desk->tail = t;
+    desk->queued++;
+    delivery_dispatch_locked(ex, t);
+    pthread_mutex_unlock(&desk->lock);
+}
+
+// Taşıma masasını koşunun asansör sayısıyla hazırlar
+static void delivery_desk_init(struct GraphExecutor *ex) {
+    struct DeliveryDesk *desk = &ex->delivery;
+    pthread_mutex_init(&desk->lock, NULL);
+    desk->head = desk->tail = NULL;
+    desk->queued = desk->busy = 0;
+    desk->hold = (struct DeliveryTrip){ { delivery_hold_task, NULL }, ex };
+    desk->hold_armed = 0;
+    desk->idle_count = crew_counts[RES_ELEVATOR];
+    for (int e = 0; e < desk->idle_count; e++) {
+        desk->idle[e] = e;
+        desk->trips[e] = (struct DeliveryTrip){ { delivery_return_task, NULL }, ex };
+    }
+}
+
+// Düğüm adım görevi: adımı bekleme noktasına kadar çalıştırır. Kaynak meşgulse görev kaynağın
+// kuyruğunda, gecikme varsa zamanlayıcıda askıya alınır ve işçi thread'i sıradaki göreve geçer.
+static void node_step_task(struct PoolTask *task) {
+    struct NodeTask *t = (struct NodeTask *)task;
+    struct GraphExecutor *ex = t->exec;
+    const struct GraphNode *node = &ex->graph->nodes[t->node];
+    const struct JobProgram *program = &job_programs[node->kind];
+    while (t->step < program->step_count) { // İç dizayn noktaları adımsızdır, doğrudan biter
+        const struct TaskStep *step = &program->steps[t->step];
+        if (t->phase != STEP_FINISH) {
+            if (t->phase == STEP_ACQUIRE && t->step == 0) log_job(node->kind, node->floor, node->apartment, 0);
+            if (step_elevator_delivery(step)) { // Asansör seferi ya da merdiven: teslim anında zamanlayıcıdan döner
+                t->phase = STEP_FINISH;
+                delivery_request(ex, t);
+                return;
+            }
+            if (step->resource != RES_NONE) {
+                uint64_t now;
+                if (t->phase == STEP_ACQUIRE) {
+                    t->mark = monotonic_ns();
+                    t->phase = STEP_GRANTED; // Kuyruğa girmeden önce: ekip hemen devredilebilir
+                    if (!resource_acquire_or_queue(step->resource, &t->task)) return;
+                    now = t->mark;
+                    resource_stats_wait(step->resource, 0, 0);
+                } else { // Kuyruktan devralındı
+                    now = monotonic_ns();
+                    resource_stats_wait(step->resource, now - t->mark, 1);
+                    schedule_waited(t->node, step->resource, (now - t->mark) / 1e9);
+                    trace_async(TRACE_RESOURCE_WAIT, step->resource, node->floor, node->apartment, t->mark - trace_epoch,
+                                (uint32_t)t->node + 1);
+                }
+                t->mark = now; // Tutma süresinin başlangıcı
+            }
+            log_step(node->kind, node->floor, node->apartment, t->step, 0);
+            t->phase = STEP_FINISH;
+            double sec = random_duration(step->min_sec, step->max_sec) * delay_scale;
+            schedule_step(t->node, t->step, sec);
+            if (sec > 0.0) {
+                task_timer_add(ex->timer, &t->task, monotonic_ns() + (uint64_t)(sec * 1e9));
+                return;
+            }
+        }
+        log_step(node->kind, node->floor, node->apartment, t->step, 1);
+        if (step->resource != RES_NONE && !step_elevator_delivery(step)) {
+            resource_stats_hold(step->resource, monotonic_ns() - t->mark);
+            resource_release_to_queue(step->resource, ex->pool); // Sıradaki bekleyene devret
+        }
+        add_step_cost(node->kind, t->step, node->floor, node->apartment); // Maliyeti kaynak bırakıldıktan sonra ekle
+        t->step++;
+        t->phase = STEP_ACQUIRE;
+        if (t->step == program->step_count) log_job(node->kind, node->floor, node->apartment, 1);
+    }
+    if (node->kind == JOB_FOUNDATION) log_message(MSG_FOUNDATION_SIGNAL, 0, 0); // İlk kat graf üzerinden serbest kalır
+    executor_complete(ex, t->node);
+}
+
+// ---------------------------------------------------------------------------
+// Ayrık olay simülasyonu (sanal zaman)
+// Gecikmeler uyumak yerine olay kuyruğundaki sanal saati ilerletir. İş sırası bağımlılık
+// grafından gelir; ekip mutex'leri ve asansör semaforu FIFO kaynak kuyruklarıyla modellenir.
+// ---------------------------------------------------------------------------
+
+// Zamanlanmış olay: bir işin o anki adımının bitişi
+struct SimEvent {
+    double time;          // Olayın gerçekleşeceği sanal zaman (gün)
+    unsigned long seq;    // Aynı zamanlı olayları ekleniş sırasıyla işlemek için sıra numarası
+    int job;              // Olayın ait olduğu iş
+};
+
+// Simülasyondaki bir iş (grafın bir düğümü)
+struct SimJob {
+    enum JobKind kind;    // İş türü
+    int floor;            // Kat numarası (-1: binaya ait)
+    int apartment;        // Daire numarası (-1: kata ait)
+    int pc;               // Çalışan adımın indeksi
+    int next_waiting;     // Kaynak bekleme kuyruğunda arkadaki iş (-1: yok)
+    double wait_since;    // Kaynak kuyruğuna girdiği sanal zaman
+};
+
+#define SIM_TICKS_PER_DAY 86400.0 // Sanal moddaki ölçümlerin birimi: simüle edilen saniye
+
+// Sanal kaynak: kapasitesi dolduğunda gelen işler FIFO kuyruğunda bekler
+struct SimResource {
+    int capacity;         // Aynı anda kullanabilecek iş sayısı
+    int in_use;           // Şu anda kullanan iş sayısı
+    int wait_head;        // Bekleme kuyruğunun başı (-1: boş)
+    int wait_tail;        // Bekleme kuyruğunun sonu
+    int queued;           // Kuyruktaki iş sayısı
+};
+
+#define SIM_DELIVERY_HOLD -1   // İş yerine asansör bekletmesinin bittiğini bildiren olay
+#define SIM_ELEVATOR_RETURN -2 // Asansörün seferden dönüşü; s. şantiyede biten sefer için SIM_ELEVATOR_RETURN - s
+
+// Malzeme taşıma sayaçları (karşılaştırma raporu için)
+struct DeliveryStats {
+    unsigned long trips;                   // Asansör seferi
+    unsigned long by_elevator;             // Asansörle taşınan daire malzemesi
+    unsigned long by_stairs;               // Merdivenle taşınan
+    double elevator_days;                  // Asansörlerin seferde geçirdiği toplam süre
+    double wait_days;                      // Asansörle taşınanların kuyrukta toplam beklemesi
+    double max_wait_days;                  // En uzun kuyruk beklemesi
+};
+
+// Simülasyon durumu
+struct Simulation {
+    struct SimEvent *heap;                 // Olay zamanına göre min-heap (öncelik kuyruğu)
+    int heap_size;                         // Kuyruktaki olay sayısı
+    int heap_capacity;                     // Kuyruk kapasitesi
+    unsigned long next_seq;                // Sonraki olay sıra numarası
+    const struct TaskGraph *graph;         // Bağımlılık grafı
+    const int *crews;                      // Kaynak başına ekip sayısı (kaynak kapasiteleri)
+    struct SimJob *jobs;                   // Düğüm başına iş
+    int *remaining;                        // Düğüm başına bitmemiş öncül sayısı
+    struct SimResource resources[RES_COUNT]; // Ekipler ve asansör
+    int record_costs;                      // 0 ise maliyet defterine ve kaynak ölçümlerine yazılmaz (karşılaştırma ve toplu koşular)
+    double total_cost;                     // Bu koşunun toplam maliyeti (defterden bağımsız)
+    unsigned long events_processed;        // İşlenen olay sayısı
+    // Portföy: aynı grafın sites kopyası aynı kaynakları paylaşır; iş indeksi site * node_count + düğüm
+    int sites;                             // Şantiye sayısı (tek bina: 1)
+    double travel_days;                    // Ekibin başka şantiyeye geçerken yolda geçirdiği süre (gün)
+    int *idle_at;                          // Kaynak ve şantiye başına boştaki ekip (yalnızca sites > 1)
+    double *site_finish;                   // Şantiye başına son işin bitişi (NULL: tutulmaz)
+    double *site_cost;                     // Şantiye başına malzeme ve işçilik maliyeti
+    unsigned long travels;                 // Şantiye değiştiren ekip sayısı
+    struct DeliveryStats delivery;         // Malzeme taşıma sayaçları
+};
+
+// Bir sanal koşunun sonucu
+struct SimResult {
+    double makespan;                       // Bitiş zamanı (gün)
+    double total_cost;                     // Toplam maliyet (TL, ekip günlükleri dahil)
+    double crew_cost;                      // Ekip günlükleri (TL)
+    unsigned long events;                  // İşlenen olay sayısı
+    struct DeliveryStats delivery;         // Malzeme taşıma sayaçları
+};
+
+// İki olayı (zaman, sıra) anahtarına göre karşılaştırır
+static int sim_event_before(const struct SimEvent *a, const struct SimEvent *b) {
+    return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+// Olayı öncelik kuyruğuna ekler
+static void sim_schedule(struct Simulation *sim, double time, int job) {
+    if (sim->heap_size == sim->heap_capacity) { // Kuyruk dolduysa büyüt
+        sim->heap_capacity = sim->heap_capacity ? sim->heap_capacity * 2 : 64;
+        sim->heap = realloc(sim->heap, sim->heap_capacity * sizeof(struct SimEvent));
+        if (!sim->heap) {
+            perror("realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+    struct SimEvent ev = { time, sim->next_seq++, job };
+    int i = sim->heap_size++;
+    while (i > 0) { // Yukarı doğru kaydır
+        int parent = (i - 1) / 2;
+        if (!sim_event_before(&ev, &sim->heap[parent])) break;
+        sim->heap[i] = sim->heap[parent];
+        i = parent;
+    }
+    sim->heap[i] = ev;
+}
+
+// En erken olayı kuyruktan çıkarır
+static struct SimEvent sim_pop(struct Simulation *sim) {
+    struct SimEvent top = sim->heap[0];
+    struct SimEvent last = sim->heap[--sim->heap_size];
+    int i = 0;
+    for (;;) { // Aşağı doğru kaydır
+        int child = 2 * i + 1;
+        if (child >= sim->heap_size) break;
+        if (child + 1 < sim->heap_size && sim_event_before(&sim->heap[child + 1], &sim->heap[child])) child++;
+        if (!sim_event_before(&sim->heap[child], &last)) break;
+        sim->heap[i] = sim->heap[child];
+        i = child;
+    }
+    sim->heap[i] = last;
+    return top;
+}
+
+// Kaynağı tutan iş için adımın süresini örnekler ve bitiş olayını zamanlar; ekip başka
+// şantiyeden geldiyse yol süresi de adımın içindedir (ekip yoldayken de tutulur)
+static void sim_run_step(struct Simulation *sim, int job_index, double travel) {
+    struct SimJob *job = &sim->jobs[job_index];
+    const struct TaskStep *step = &job_programs[job->kind].steps[job->pc];
+    log_step(job->kind, job->floor, job->apartment, job->pc, 0);
+    double duration = random_duration(step->min_sec, step->max_sec) + travel;
+    if (sim->record_costs && step->resource != RES_NONE) {
+        resource_stats_hold(step->resource, (uint64_t)(duration * SIM_TICKS_PER_DAY));
+    }
+    if (sim->record_costs) schedule_step(job_index, job->pc, duration);
+    sim_schedule(sim, virtual_now + duration, job_index);
+}
+
+// İşin şantiyesi
+static inline int sim_site(const struct Simulation *sim, int job_index) {
+    return sim->sites > 1 ? job_index / sim->graph->node_count : 0;
+}
+
+// Boştaki bir ekibi işe verir ve yol süresini döndürür: önce işin şantiyesindeki ekip,
+// yoksa ilk boş ekibin bulunduğu şantiyeden gelen ekip
+static double sim_crew_take(struct Simulation *sim, enum ResourceId res, int job_index) {
+    if (sim->sites == 1) return 0.0;
+    int *idle = &sim->idle_at[res * sim->sites];
+    int site = sim_site(sim, job_index);
+    if (idle[site] > 0) {
+        idle[site]--;
+        return 0.0;
+    }
+    for (int s = 0; s < sim->sites; s++) {
+        if (idle[s] > 0) {
+            idle[s]--;
+            sim->travels++;
+            return sim->travel_days;
+        }
+    }
+    return 0.0; // in_use < capacity iken buraya gelinmez
+}
+
+// İşin sıradaki adımını başlatır; kaynak meşgulse iş kaynağın kuyruğuna girer
+// Ana koşunun kaynak durumunu canlı ölçümlere yansıtır (karşılaştırma ve toplu koşular yazmaz)
+static inline void sim_live_resource(const struct Simulation *sim, enum ResourceId res) {
+    if (!sim->record_costs) return;
+    atomic_store_explicit(&live_busy[res], sim->resources[res].in_use, memory_order_relaxed);
+    atomic_store_explicit(&live_queued[res], sim->resources[res].queued, memory_order_relaxed);
+}
+
+// Asansörle taşınan malzemenin kuyruk beklemesini sayar
+static void sim_delivery_waited(struct Simulation *sim, double wait) {
+    sim->delivery.wait_days += wait;
+    if (wait > sim->delivery.max_wait_days) sim->delivery.max_wait_days = wait;
+}
+
+// Asansör kuyruğunun en eski isteklerinden bir sefer kurar: seçilen işlerin adımları kendi
+// katlarına varışta, sefer de asansörün dönüşünde biter. Boş asansör varken çağrılır; kabin
+// dolmuyorsa ve en eski istek bekletme süresini doldurmadıysa sefer kurmadan 0 döndürür.
+// Portföyde sefer yalnızca en eski isteğin şantiyesindeki istekleri toplar; o şantiyede boş
+// asansör yoksa başka şantiyeden gelen asansör yol süresini seferin başında geçirir.
+static int sim_delivery_trip(struct Simulation *sim) {
+    struct SimResource *r = &sim->resources[RES_ELEVATOR];
+    int window[DELIVERY_WINDOW], floors[DELIVERY_WINDOW], count = 0;
+    int site = sim_site(sim, r->wait_head);
+    for (int j = r->wait_head, seen = 0; j >= 0 && count < DELIVERY_WINDOW && seen < 4 * DELIVERY_WINDOW;
+         j = sim->jobs[j].next_waiting, seen++) {
+        if (sim_site(sim, j) != site) continue;
+        window[count] = j;
+        floors[count++] = sim->jobs[j].floor;
+    }
+    if (count == 0 || (count < delivery_capacity() && virtual_now < sim->jobs[window[0]].wait_since + delivery_hold_days())) {
+        return 0;
+    }
+    int picked[MAX_ELEVATOR_CAPACITY], batch[MAX_ELEVATOR_CAPACITY], batch_floors[MAX_ELEVATOR_CAPACITY] = { 0 };
+    int n = delivery_pick(floors, count, picked);
+    for (int i = 0; i < n; i++) {
+        batch[i] = window[picked[i]];
+        batch_floors[i] = floors[picked[i]];
+    }
+    for (int j = r->wait_head, prev = -1, removed = 0; j >= 0 && removed < n;) { // Seçilenleri kuyruktan çıkar
+        int next = sim->jobs[j].next_waiting;
+        int chosen = 0;
+        for (int i = 0; i < n && !chosen; i++) chosen = batch[i] == j;
+        if (chosen) {
+            if (prev < 0) r->wait_head = next;
+            else sim->jobs[prev].next_waiting = next;
+            if (r->wait_tail == j) r->wait_tail = prev;
+            removed++;
+        } else {
+            prev = j;
+        }
+        j = next;
+    }
+    r->queued -= n;
+    r->in_use++;
+    sim_live_resource(sim, RES_ELEVATOR);
+
+    double arrive[MAX_ELEVATOR_CAPACITY];
+    double travel = sim_crew_take(sim, RES_ELEVATOR, window[0]); // Asansör başka şantiyedeyse önce gelir
+    double trip = delivery_trip(batch_floors, n, arrive) + travel;
+    for (int i = 0; i < n; i++) {
+        arrive[i] += travel;
+        struct SimJob *job = &sim->jobs[batch[i]];
+        double wait = virtual_now - job->wait_since;
+        sim_delivery_waited(sim, wait);
+        if (sim->record_costs) {
+            resource_stats_wait(RES_ELEVATOR, (uint64_t)(wait * SIM_TICKS_PER_DAY), wait > 0.0);
+            schedule_waited(batch[i], RES_ELEVATOR, wait);
+            schedule_step(batch[i], job->pc, arrive[i]);
+        }
+        log_step(job->kind, job->floor, job->apartment, job->pc, 0);
+        sim_schedule(sim, virtual_now + arrive[i], batch[i]);
+    }
+    sim->delivery.trips++;
+    sim->delivery.by_elevator += n;
+    sim->delivery.elevator_days += trip;
+    if (sim->record_costs) resource_stats_hold(RES_ELEVATOR, (uint64_t)(trip * SIM_TICKS_PER_DAY));
+    sim_schedule(sim, virtual_now + trip, SIM_ELEVATOR_RETURN - site); // Asansör sefer bitince bu şantiyededir
+    return 1;
+}
+
+// Boş asansör ve kalkmaya hazır sefer oldukça sefer kurar
+static void sim_delivery_dispatch(struct Simulation *sim) {
+    struct SimResource *r = &sim->resources[RES_ELEVATOR];
+    while (r->in_use < r->capacity && r->wait_head >= 0 && sim_delivery_trip(sim)) {
+    }
+    sim_live_resource(sim, RES_ELEVATOR);
+}
+
+// Malzeme isteği: kuyruk uzunsa merdivenle taşınır, değilse kuyruğa girer; boş asansör varsa sefer kurulur
+static void sim_delivery_request(struct Simulation *sim, int job_index) {
+    struct SimJob *job = &sim->jobs[job_index];
+    struct SimResource *r = &sim->resources[RES_ELEVATOR];
+    if (delivery_use_stairs(job->floor, r->queued, r->in_use, r->capacity)) {
+        sim->delivery.by_stairs++;
+        log_step(job->kind, job->floor, job->apartment, job->pc, 0);
+        if (sim->record_costs) schedule_step(job_index, job->pc, stairs_days(job->floor));
+        sim_schedule(sim, virtual_now + stairs_days(job->floor), job_index);
+        return;
+    }
+    job->next_waiting = -1;
+    job->wait_since = virtual_now;
+    if (r->wait_head < 0) r->wait_head = job_index;
+    else sim->jobs[r->wait_tail].next_waiting = job_index;
+    r->wait_tail = job_index;
+    r->queued++;
+    if (delivery_hold_days() > 0.0) sim_schedule(sim, virtual_now + delivery_hold_days(), SIM_DELIVERY_HOLD);
+    sim_delivery_dispatch(sim);
+}
+
+// Asansör seferden döndü: seferin şantiyesinde boşa çıkar, kuyrukta hazır sefer varsa yenisine çıkar
+static void sim_elevator_return(struct Simulation *sim, int site) {
+    struct SimResource *r = &sim->resources[RES_ELEVATOR];
+    r->in_use--;
+    if (sim->sites > 1) sim->idle_at[RES_ELEVATOR * sim->sites + site]++;
+    sim_delivery_dispatch(sim);
+}
+
+static void sim_begin_step(struct Simulation *sim, int job_index) {
+    struct SimJob *job = &sim->jobs[job_index];
+    const struct TaskStep *step = &job_programs[job->kind].steps[job->pc];
+    enum ResourceId res = step->resource;
+    if (step_elevator_delivery(step)) {
+        sim_delivery_request(sim, job_index);
+        return;
+    }
+    if (res != RES_NONE) {
+        struct SimResource *r = &sim->resources[res];
+        if (r->in_use >= r->capacity) { // Kaynak meşgul: kuyruğun sonuna eklen
+            job->next_waiting = -1;
+            job->wait_since = virtual_now;
+            if (r->wait_head < 0) r->wait_head = job_index;
+            else sim->jobs[r->wait_tail].next_waiting = job_index;
+            r->wait_tail = job_index;
+            r->queued++;
+            sim_live_resource(sim, res);
+            return;
+        }
+        r->in_use++;
+        sim_live_resource(sim, res);
+        if (sim->record_costs) resource_stats_wait(res, 0, 0);
+        sim_run_step(sim, job_index, sim_crew_take(sim, res, job_index));
+        return;
+    }
+    sim_run_step(sim, job_index, 0.0);
+}
+
+// Kaynak devrini ize yazar: bırakan işin adımından bekleyen işin bekleme aralığına akış oku
+static void trace_handoff(struct Simulation *sim, int releaser, int next, enum ResourceId res) {
+    if (!trace_arena) return;
+    const struct SimJob *from = &sim->jobs[releaser], *to = &sim->jobs[next];
+    uint32_t id = atomic_fetch_add_explicit(&trace_flow_ids, 1, memory_order_relaxed) + 1;
+    uint64_t now = trace_now();
+    trace_record('s', TRACE_HANDOFF, res, 0, from->floor, from->apartment, now - 1, 0, id,
+                 trace_lane(from->kind, from->floor, from->apartment)); // Bitmekte olan adımın içinde
+    trace_span(TRACE_RESOURCE_WAIT, res, to->floor, to->apartment, (uint64_t)(to->wait_since * TRACE_NS_PER_DAY),
+               'f', id, trace_lane(to->kind, to->floor, to->apartment));
+}
+
+// Kaynağı bırakır; kuyrukta bekleyen varsa kaynak doğrudan ona devredilir
+static void sim_release(struct Simulation *sim, int releaser, enum ResourceId res) {
+    if (res == RES_NONE) return;
+    struct SimResource *r = &sim->resources[res];
+    if (r->wait_head < 0) {
+        r->in_use--;
+        sim_live_resource(sim, res);
+        if (sim->sites > 1) sim->idle_at[res * sim->sites + sim_site(sim, releaser)]++; // Ekip şantiyede kalır
+        return;
+    }
+    int next = r->wait_head;
+    r->wait_head = sim->jobs[next].next_waiting;
+    r->queued--;
+    sim_live_resource(sim, res);
+    if (sim->record_costs) {
+        resource_stats_wait(res, (uint64_t)((virtual_now - sim->jobs[next].wait_since) * SIM_TICKS_PER_DAY), 1);
+        schedule_waited(next, res, virtual_now - sim->jobs[next].wait_since);
+        trace_handoff(sim, releaser, next, res);
+    }
+    double travel = 0.0;
+    if (sim_site(sim, next) != sim_site(sim, releaser)) { // Ekip sıradaki işin şantiyesine gider
+        travel = sim->travel_days;
+        sim->travels++;
+    }
+    sim_run_step(sim, next, travel); // Kaynak sayısı değişmeden sıradaki işe geçer
+}
+
+static void sim_job_finished(struct Simulation *sim, int job_index);
+
+// Öncülleri biten işi ilk adımından başlatır; adımsız işler hemen biter. driver işi serbest
+// bırakan son öncüldür (-1: öncülü yok)
+static void sim_start_job(struct Simulation *sim, int job_index, int driver) {
+    struct SimJob *job = &sim->jobs[job_index];
+    if (sim->sites == 1) graph_node_released(&sim->graph->nodes[job_index]); // Portföy koşuları başlık yazmaz
+    if (sim->record_costs) schedule_released(job_index, driver);
+    job->pc = 0;
+    if (job_programs[job->kind].step_count == 0) {
+        sim_job_finished(sim, job_index);
+        return;
+    }
+    log_job(job->kind, job->floor, job->apartment, 0);
+    sim_begin_step(sim, job_index);
+}
+
+// Biten işin ardıllarının sayaçlarını azaltır; sayacı sıfırlanan ardıl aynı anda başlar
+static void sim_job_finished(struct Simulation *sim, int job_index) {
+    struct SimJob *job = &sim->jobs[job_index];
+    const struct TaskGraph *g = sim->graph;
+    if (job_programs[job->kind].step_count > 0) log_job(job->kind, job->floor, job->apartment, 1);
+    int site = sim_site(sim, job_index);
+    int base = site * g->node_count; // Ardıllar aynı şantiyededir
+    int node = job_index - base;
+    if (sim->sites == 1) graph_node_finished(&g->nodes[node]);
+    if (sim->record_costs) schedule_finished(node);
+    if (sim->site_finish) sim->site_finish[site] = virtual_now; // Olaylar zaman sırasında: son atama en geç bitiştir
+    for (int e = g->succ_start[node]; e < g->succ_start[node + 1]; e++) {
+        int next = base + g->succ[e];
+        if (--sim->remaining[next] == 0) sim_start_job(sim, next, job_index);
+    }
+}
+
+// Adım bitiş olayını işler: kaynağı bırakır, maliyeti ekler ve sıradaki adıma geçer
+static void sim_handle_event(struct Simulation *sim, int job_index) {
+    if (job_index == SIM_DELIVERY_HOLD) { // En eski isteğin bekletmesi bitti
+        sim_delivery_dispatch(sim);
+        return;
+    }
+    if (job_index <= SIM_ELEVATOR_RETURN) {
+        sim_elevator_return(sim, SIM_ELEVATOR_RETURN - job_index);
+        return;
+    }
+    struct SimJob *job = &sim->jobs[job_index];
+    const struct JobProgram *program = &job_programs[job->kind];
+    const struct TaskStep *step = &program->steps[job->pc];
+
+    log_step(job->kind, job->floor, job->apartment, job->pc, 1);
+    if (!step_elevator_delivery(step)) sim_release(sim, job_index, step->resource); // Asansörü sefer bırakır
+    int64_t material, labor;
+    step_cost(job->kind, job->pc, &material, &labor);
+    sim->total_cost += (material + labor) / 100.0;
+    if (sim->site_cost) sim->site_cost[sim_site(sim, job_index)] += (material + labor) / 100.0;
+    if (sim->record_costs) add_step_cost(job->kind, job->pc, job->floor, job->apartment);
+    else event_log_step(job->kind, job->floor, job->apartment, job->pc, 1, material, labor); // Toplu kopyalar
+
+    if (++job->pc < program->step_count) sim_begin_step(sim, job_index);
+    else sim_job_finished(sim, job_index);
+}
+
+// ---------------------------------------------------------------------------
+// Kontrol noktası (--checkpoint=DOSYA): sanal koşunun tüm durumu (olay kuyruğu, işler, kaynak
+// kuyrukları, sanal saat, RNG, maliyet dilimleri, daire dizileri, kaynak ölçümleri ve kritik yol
+// kaydı) belirli aralıklarla dosyaya yazılır. Olaylar arasında alınan durum kendiliğinden
+// tutarlıdır. Yazma fork edilmiş çocukta yapılır: özel bellek yazma-üzerine-kopyalama ile o anda
+// donar, ana süreç beklemeden devam eder. Paylaşılan eşleme COW değildir; onun payı fork'tan önce özel bir gölge
+// kopyaya alınır. Çocuk dosyayı geçici adla eşleyip doldurur, diske yazar ve adını atomik olarak
+// değiştirir; bu yüzden çökme anında diskte ya önceki ya da yeni kontrol noktası tam olarak durur.
+// --resume=DOSYA koşuyu kaydedilen yapılandırma ve durumla kaldığı olaydan sürdürür.
+// ---------------------------------------------------------------------------
+
+#define CHECKPOINT_MAGIC 0x31544b4e5a534e49ULL // "INSZNKT1"
+#define CHECKPOINT_VERSION 6
+
+// Kaynak ölçümlerinin kayda giren kısmı
+struct StatsSnapshot {
+    struct Histogram wait[RES_COUNT];
+    struct Histogram hold[RES_COUNT];
+    uint64_t contended[RES_COUNT];
+};
+
+// Dosyanın başı; bölümler önbellek satırına hizalı olarak arkasından gelir
+struct CheckpointHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t file_size;
+    uint64_t checksum;                   // Başlıktan sonraki tüm baytların özeti
+    uint64_t program_hash;               // Adım tablolarının özeti (aynı programla devam edilmeli)
+    // Yapılandırma: devam ederken bunlar dosyadan alınır
+    uint64_t seed;
+    int32_t floors, apartments, days, schedule;
+    int32_t deliveries, elevator_capacity;
+    double delivery_hold;
+    int32_t crews[RES_COUNT];
+    double crew_day_costs[RES_COUNT];
+    int32_t node_count;
+    // Olay döngüsünün durumu
+    int32_t heap_size;
+    double virtual_now;
+    uint64_t next_seq;
+    uint64_t events_processed;
+    double total_cost;
+    struct DeliveryStats delivery;
+    struct SimResource resources[RES_COUNT];
+    struct RngStream rng;                // Olay döngüsü thread'inin akışı
+    // Bölümlerin dosya içindeki konumları
+    uint64_t heap_at, jobs_at, remaining_at, progress_at, unit_cost_at, shards_at, stats_at, timing_at, steps_at;
+};
+
+static char *checkpoint_shadow;          // Paylaşılan eşlemeden alınan gölge kopya (daire dizileri ve dilimler)
+static pid_t checkpoint_writer;          // Yazmakta olan çocuk (0: yok)
+static long checkpoints_written;         // Başlatılan kontrol noktası yazımı
+static long checkpoints_skipped;         // Önceki yazım bitmediği için atlanan kontrol noktası
+static double checkpoint_last_day;       // Son kontrol noktasının sanal günü
+static uint64_t checkpoint_stall_ns;     // Olay döngüsünün kontrol noktası için durduğu toplam süre
+static const struct CheckpointHeader *checkpoint_resume; // --resume ile eşlenen dosya
+static size_t checkpoint_resume_size;
+
+#define CHECKPOINT_ALIGN(x) (((x) + CACHE_LINE - 1) & ~(uint64_t)(CACHE_LINE - 1))
+
+// 64 bitlik sözcüklerle FNV-1a özeti (bölümler 8 bayta hizalıdır)
+static uint64_t checkpoint_hash(const void *data, size_t size, uint64_t hash) {
+    const uint64_t *word = data;
+    for (size_t i = 0; i < size / 8; i++) hash = (hash ^ word[i]) * 0x100000001b3ULL;
+    return hash;
+}
+
+// Adım tablolarının özeti: süreleri ya da maliyetleri değişmiş bir programla devam edilmesin
+static uint64_t checkpoint_program_hash(void) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int k = 0; k < JOB_KIND_COUNT; k++) {
+        for (int i = 0; i < job_programs[k].step_count; i++) {
+            const struct TaskStep *step = &job_programs[k].steps[i];
+            uint64_t fields[4] = { 0, 0, (uint64_t)step->resource << 8 | (uint64_t)step->per_floor, 0 };
+            memcpy(&fields[0], &step->min_sec, sizeof(double));
+            memcpy(&fields[1], &step->max_sec, sizeof(double));
+            memcpy(&fields[3], &prices.material[price_item(k, i)], sizeof(double)); // Fiyatlar da aynı olmalı
+            hash = checkpoint_hash(fields, sizeof(fields), hash);
+        }
+    }
+    return checkpoint_hash(prices.labor_ratio, sizeof(prices.labor_ratio), hash);
+}
+
+// Bölüm konumlarını hesaplar ve dosya boyutunu döndürür
+static uint64_t checkpoint_layout(struct CheckpointHeader *h, long unit_count) {
+    uint64_t at = CHECKPOINT_ALIGN(sizeof(struct CheckpointHeader));
+    h->heap_at = at;      at = CHECKPOINT_ALIGN(at + (uint64_t)h->heap_size * sizeof(struct SimEvent));
+    h->jobs_at = at;      at = CHECKPOINT_ALIGN(at + (uint64_t)h->node_count * sizeof(struct SimJob));
+    h->remaining_at = at; at = CHECKPOINT_ALIGN(at + (uint64_t)h->node_count * sizeof(int));
+    h->progress_at = at;  at = CHECKPOINT_ALIGN(at + (uint64_t)unit_count * sizeof(uint8_t));
+    h->unit_cost_at = at; at = CHECKPOINT_ALIGN(at + unit_cost_bytes());
+    h->shards_at = at;    at = CHECKPOINT_ALIGN(at + (COST_SHARDS + 1) * sizeof(struct CostShard));
+    h->stats_at = at;     at = CHECKPOINT_ALIGN(at + sizeof(struct StatsSnapshot));
+    h->timing_at = at;    at = CHECKPOINT_ALIGN(at + (uint64_t)h->node_count * sizeof(struct NodeTiming));
+    h->steps_at = at;     at = CHECKPOINT_ALIGN(at + schedule_steps_bytes());
+    return at;
+}
+
+// Çocuk süreçte: kontrol noktasını geçici dosyaya yazıp atomik olarak yerine koyar
+static int checkpoint_write(const struct Simulation *sim, const struct CheckpointHeader *header) {
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", checkpoint_path);
+    int fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, (off_t)header->file_size) != 0) return -1;
+    char *file = mmap(NULL, header->file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (file == MAP_FAILED) return -1;
+    long unit_count = units.count;
+    size_t shadow_units = CHECKPOINT_ALIGN(unit_count * sizeof(uint8_t)) + CHECKPOINT_ALIGN(unit_cost_bytes());
+    memcpy(file, header, sizeof(*header));
+    memcpy(file + header->heap_at, sim->heap, header->heap_size * sizeof(struct SimEvent));
+    memcpy(file + header->jobs_at, sim->jobs, header->node_count * sizeof(struct SimJob));
+    memcpy(file + header->remaining_at, sim->remaining, header->node_count * sizeof(int));
+    memcpy(file + header->progress_at, checkpoint_shadow, unit_count * sizeof(uint8_t));
+    memcpy(file + header->unit_cost_at, checkpoint_shadow + CHECKPOINT_ALIGN(unit_count * sizeof(uint8_t)), unit_cost_bytes());
+    memcpy(file + header->shards_at, checkpoint_shadow + shadow_units, (COST_SHARDS + 1) * sizeof(struct CostShard));
+    struct StatsSnapshot *stats = (struct StatsSnapshot *)(file + header->stats_at);
+    struct ResourceStats *local = resource_stats_local();
+    memcpy(stats->wait, local->wait, sizeof(stats->wait));
+    memcpy(stats->hold, local->hold, sizeof(stats->hold));
+    memcpy(stats->contended, local->contended, sizeof(stats->contended));
+    if (schedule_log.nodes) { // Özel bellek: fork anındaki hali
+        memcpy(file + header->timing_at, schedule_log.nodes, header->node_count * sizeof(struct NodeTiming));
+        memcpy(file + header->steps_at, schedule_log.steps, schedule_steps_bytes());
+    }
+    uint64_t header_end = CHECKPOINT_ALIGN(sizeof(struct CheckpointHeader));
+    ((struct CheckpointHeader *)file)->checksum =
+        checkpoint_hash(file + header_end, header->file_size - header_end, 0xcbf29ce484222325ULL);
+    int ok = msync(file, header->file_size, MS_SYNC) == 0;
+    munmap(file, header->file_size);
+    ok = ok && fsync(fd) == 0 && close(fd) == 0;
+    return ok && rename(tmp, checkpoint_path) == 0 ? 0 : -1;
+}
+
+// Önceki yazımı toplar; yazım başarısız olduysa koşuyu durdurur. block 0 ise bitmemiş yazımı beklemez.
+static int checkpoint_reap(int block) {
+    if (checkpoint_writer <= 0) return 1;
+    int status;
+    pid_t done = waitpid(checkpoint_writer, &status, block ? 0 : WNOHANG);
+    if (done == 0) return 0;
+    checkpoint_writer = 0;
+    if (done < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "Kontrol noktası yazılamadı: %s\n", checkpoint_path);
+        exit(EXIT_FAILURE);
+    }
+    return 1;
+}
+
+// Olay döngüsünün şu anki durumunun kontrol noktasını başlatır
+static void checkpoint_save(const struct Simulation *sim) {
+    if (!checkpoint_reap(0)) { // Disk yavaş: yazım sürerken yenisini başlatma
+        checkpoints_skipped++;
+        return;
+    }
+    uint64_t start = monotonic_ns();
+    long unit_count = units.count;
+    size_t shadow_units = CHECKPOINT_ALIGN(unit_count * sizeof(uint8_t)) + CHECKPOINT_ALIGN(unit_cost_bytes());
+    if (!checkpoint_shadow) {
+        checkpoint_shadow = malloc(shadow_units + (COST_SHARDS + 1) * sizeof(struct CostShard));
+        if (!checkpoint_shadow) {
+            perror("malloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+    memcpy(checkpoint_shadow, (const void *)units.progress, unit_count * sizeof(uint8_t));
+    memcpy(checkpoint_shadow + CHECKPOINT_ALIGN(unit_count * sizeof(uint8_t)), units.cost, unit_cost_bytes());
+    memcpy(checkpoint_shadow + shadow_units, shared_data->shards, COST_SHARDS * sizeof(struct CostShard));
+    memcpy(checkpoint_shadow + shadow_units + COST_SHARDS * sizeof(struct CostShard), &shared_data->overflow,
+           sizeof(struct CostShard));
+
+    struct CheckpointHeader header = {
+        .magic = CHECKPOINT_MAGIC, .version = CHECKPOINT_VERSION, .header_size = sizeof(struct CheckpointHeader),
+        .program_hash = checkpoint_program_hash(), .seed = run_seed,
+        .floors = total_floors, .apartments = apartments_per_floor, .days = total_days, .schedule = schedule_mode,
+        .deliveries = delivery_mode, .elevator_capacity = elevator_capacity, .delivery_hold = delivery_hold,
+        .node_count = sim->graph->node_count, .heap_size = sim->heap_size, .virtual_now = virtual_now,
+        .next_seq = sim->next_seq, .events_processed = sim->events_processed, .total_cost = sim->total_cost,
+        .delivery = sim->delivery,
+        .rng = rng, // fork sonrası çocuğun akışı yeniden tohumlanır: akış burada alınmalı
+    };
+    for (int r = 0; r < RES_COUNT; r++) {
+        header.crews[r] = crew_counts[r];
+        header.crew_day_costs[r] = crew_day_costs[r];
+        header.resources[r] = sim->resources[r];
+    }
+    header.file_size = checkpoint_layout(&header, unit_count);
+
+    pid_t pid = fork();
+    if (pid == 0) _exit(checkpoint_write(sim, &header) == 0 ? 0 : 1);
+    if (pid < 0) {
+        perror("fork hatası");
+        exit(EXIT_FAILURE);
+    }
+    checkpoint_writer = pid;
+    checkpoints_written++;
+    checkpoint_last_day = virtual_now;
+    checkpoint_stall_ns += monotonic_ns() - start;
+}
+
+// --resume: dosyayı eşler, doğrular ve yapılandırmayı dosyadan alır (paylaşılan bellek
+// boyutlanmadan, seçenekler okunduktan hemen sonra çağrılır)
+void checkpoint_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror("kontrol noktası açılamadı");
+        exit(EXIT_FAILURE);
+    }
+    const struct CheckpointHeader *h = NULL;
+    if ((size_t)st.st_size >= sizeof(struct CheckpointHeader)) {
+        h = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        if (h == MAP_FAILED) h = NULL;
+    }
+    close(fd);
+    uint64_t header_end = CHECKPOINT_ALIGN(sizeof(struct CheckpointHeader));
+    if (!h || h->magic != CHECKPOINT_MAGIC || h->version != CHECKPOINT_VERSION ||
+        h->header_size != sizeof(struct CheckpointHeader) || h->file_size != (uint64_t)st.st_size ||
+        h->checksum != checkpoint_hash((const char *)h + header_end, h->file_size - header_end, 0xcbf29ce484222325ULL)) {
+        fprintf(stderr, "Geçersiz ya da bozuk kontrol noktası: %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    if (h->program_hash != checkpoint_program_hash()) {
+        fprintf(stderr, "Kontrol noktası farklı adım tablolarıyla yazılmış: %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    run_mode = MODE_VIRTUAL; // Kontrol noktası yalnızca tekrarlanabilir sanal koşudan alınır
+    run_seed = h->seed;
+    seed_given = 1;
+    total_floors = h->floors;
+    apartments_per_floor = h->apartments;
+    total_days = h->days;
+    schedule_mode = (enum ScheduleMode)h->schedule;
+    delivery_mode = (enum DeliveryMode)h->deliveries;
+    elevator_capacity = h->elevator_capacity;
+    delivery_hold = h->delivery_hold;
+    for (int r = 0; r < RES_COUNT; r++) {
+        crew_counts[r] = h->crews[r];
+        crew_day_costs[r] = h->crew_day_costs[r];
+    }
+    checkpoint_resume = h;
+    checkpoint_resume_size = st.st_size;
+}
+
+// Olay döngüsünü kontrol noktasındaki durumla doldurur
+static void checkpoint_restore(struct Simulation *sim) {
+    const struct CheckpointHeader *h = checkpoint_resume;
+    const char *file = (const char *)h;
+    long unit_count = units.count;
+    if (h->node_count != sim->graph->node_count || (long)h->floors * h->apartments != unit_count) {
+        fprintf(stderr, "Kontrol noktası bu binaya ait değil\n");
+        exit(EXIT_FAILURE);
+    }
+    sim->heap_capacity = h->heap_size > 64 ? h->heap_size : 64;
+    sim->heap = malloc(sim->heap_capacity * sizeof(struct SimEvent));
+    if (!sim->heap) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    sim->heap_size = h->heap_size;
+    memcpy(sim->heap, file + h->heap_at, h->heap_size * sizeof(struct SimEvent));
+    memcpy(sim->jobs, file + h->jobs_at, h->node_count * sizeof(struct SimJob));
+    memcpy(sim->remaining, file + h->remaining_at, h->node_count * sizeof(int));
+    memcpy((void *)units.progress, file + h->progress_at, unit_count * sizeof(uint8_t));
+    memcpy(units.cost, file + h->unit_cost_at, unit_cost_bytes());
+    memcpy(shared_data->shards, file + h->shards_at, COST_SHARDS * sizeof(struct CostShard));
+    memcpy(&shared_data->overflow, file + h->shards_at + COST_SHARDS * sizeof(struct CostShard), sizeof(struct CostShard));
+    const struct StatsSnapshot *stats = (const struct StatsSnapshot *)(file + h->stats_at);
+    struct ResourceStats *local = resource_stats_local();
+    memcpy(local->wait, stats->wait, sizeof(stats->wait));
+    memcpy(local->hold, stats->hold, sizeof(stats->hold));
+    memcpy(local->contended, stats->contended, sizeof(stats->contended));
+    if (schedule_log.nodes) {
+        memcpy(schedule_log.nodes, file + h->timing_at, h->node_count * sizeof(struct NodeTiming));
+        memcpy(schedule_log.steps, file + h->steps_at, schedule_steps_bytes());
+    }
+    for (int r = 0; r < RES_COUNT; r++) sim->resources[r] = h->resources[r];
+    sim->next_seq = h->next_seq;
+    sim->events_processed = h->events_processed;
+    sim->total_cost = h->total_cost;
+    sim->delivery = h->delivery;
+    virtual_now = h->virtual_now;
+    rng = h->rng;
+    rng_ready = 1;
+    checkpoint_last_day = h->virtual_now;
+    munmap((void *)h, checkpoint_resume_size);
+    checkpoint_resume = NULL;
+}
+
+// Grafı verilen ekip sayılarıyla sanal zamanda simüle eden fonksiyon; bitiş zamanını (gün) döndürür.
+// record_costs 0 ise maliyetler deftere yazılmaz; result NULL değilse koşunun özeti yazılır.
+// Simülasyonu grafın sites kopyası için hazırlar; ekipler şantiyelere sırayla dağıtılır
+static void sim_setup(struct Simulation *sim, const struct TaskGraph *graph, const int *crews, int record_costs, int sites) {
+    memset(sim, 0, sizeof(*sim));
+    sim->graph = graph;
+    sim->crews = crews;
+    sim->record_costs = record_costs;
+    sim->sites = sites;
+    long job_count = (long)sites * graph->node_count;
+    sim->jobs = calloc(job_count, sizeof(struct SimJob));
+    sim->remaining = malloc(job_count * sizeof(int));
+    if (!sim->jobs || !sim->remaining) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // İşleri grafın düğümlerinden oluştur
+    for (long j = 0; j < job_count; j++) {
+        int n = (int)(j % graph->node_count);
+        const struct GraphNode *node = &graph->nodes[n];
+        sim->jobs[j] = (struct SimJob){ node->kind, node->floor, node->apartment, 0, -1, 0.0 };
+        sim->remaining[j] = graph->indegree[n];
+    }
+
+    // Kaynak kapasiteleri ekip sayılarıdır (gerçek moddaki semaforların başlangıç değeri)
+    for (int r = 0; r < RES_COUNT; r++) {
+        sim->resources[r] = (struct SimResource){ crews[r], 0, -1, -1, 0 };
+    }
+    if (sites > 1) {
+        sim->idle_at = calloc((size_t)RES_COUNT * sites, sizeof(int));
+        if (!sim->idle_at) {
+            perror("calloc failed");
+            exit(EXIT_FAILURE);
+        }
+        for (int r = 0; r < RES_COUNT; r++) {
+            for (int i = 0; i < crews[r]; i++) sim->idle_at[r * sites + i % sites]++;
+        }
+    }
+}
+
+// Öncülü olmayan işlerle (temel atma) her şantiyeyi başlatır
+static void sim_start(struct Simulation *sim) {
+    virtual_now = 0.0;
+    for (int site = 0; site < sim->sites; site++) {
+        for (int n = 0; n < sim->graph->node_count; n++) {
+            if (sim->graph->indegree[n] == 0) sim_start_job(sim, site * sim->graph->node_count + n, -1);
+        }
+    }
+}
+
+static void sim_teardown(struct Simulation *sim) {
+    free(sim->heap);
+    free(sim->jobs);
+    free(sim->remaining);
+    free(sim->idle_at);
+}
+
+double run_virtual_simulation(const struct TaskGraph *graph, const int *crews, int record_costs, struct SimResult *result) {
+    struct Simulation sim;
+    sim_setup(&sim, graph, crews, record_costs, 1);
+
+    int checkpointed = record_costs && checkpoint_path; // Yalnızca defteri yazan asıl koşu
+    if (record_costs && checkpoint_resume) checkpoint_restore(&sim); // Kaldığı olaydan devam et
+    else sim_start(&sim);
+
+    // Olay döngüsü: en erken olayı al, saati o ana ilerlet ve işle
+    while (sim.heap_size > 0) {
+        struct SimEvent ev = sim_pop(&sim);
+        virtual_now = ev.time;
+        sim.events_processed++;
+        sim_handle_event(&sim, ev.job);
+        if (checkpointed && sim.events_processed % checkpoint_every == 0) checkpoint_save(&sim);
+        if (record_costs && halt_at_day > 0.0 && virtual_now >= halt_at_day) { // Çökme benzetimi
+            fprintf(stderr, "Sanal gün %.2f: süreç --halt-at ile öldürülüyor\n", virtual_now);
+            raise(SIGKILL);
+        }
+    }
+    if (checkpointed) checkpoint_reap(1); // Son yazım bitsin
+
+    double crew = crew_cost(crews, virtual_now); // Ekipler bina bitene kadar şantiyede
+    if (record_costs) add_crew_cost(crews, virtual_now);
+    else event_log_emit(EVENT_COST, JOB_KIND_COUNT, 0, -1, -1, CAT_CREW, 0, to_kurus(crew));
+    if (result) *result = (struct SimResult){ virtual_now, sim.total_cost + crew, crew, sim.events_processed, sim.delivery };
+    sim_teardown(&sim);
+    return virtual_now;
+}
+
+#define FLOOR_POLL_MS 20  // Bildirim bu kadar gecikirse ana süreç ölen kat süreçlerini arar
+
+// Katı çalıştırmaya gönderir: kalıcı işçilerin kuyruğuna koyar ya da ayrı bir süreç fork eder
+static void floor_dispatch(struct GraphExecutor *ex, int floor) {
+    ex->floor_attempts[floor]++;
+    ex->floors_running++;
+    log_message(MSG_FLOOR_WAIT, floor+1, 0);
+    if (ex->procs) {
+        floor_queue_push(&shared_data->floor_work, floor);
+        return;
+    }
+    pid_t pid = fork();             // Yeni süreç oluştur
+    if (pid == 0) {                 // Çocuk süreç
+        trace_name(TRACE_NAME_FLOOR, floor); // İzde süreci katıyla adlandır
+        floor_construction(floor);  // Kat inşaatını gerçekleştir ve bildir
+        _exit(0);                   // Çocuk süreci sonlandır (ebeveynden kalan stdio tamponlarını yazmadan)
+    } else if (pid < 0) {
+        perror("fork hatası");      // Hata kontrolü
+        exit(EXIT_FAILURE);
+    }
+    ex->floor_pid[floor] = pid;
+}
+
+// Katın bildirimini işler: gecikmeyi ölçer ve kat düğümünü bitirir
+static void floor_received(struct GraphExecutor *ex, const struct FloorMessage *msg) {
+    ex->floor_messages++;
+    hist_add(&floor_handoff_hist, monotonic_ns() - msg->posted_ns);
+    if (msg->floor < 0 || msg->floor >= total_floors || msg->status != 0 || ex->floor_done[msg->floor]) {
+        fprintf(stderr, "Geçersiz kat bildirimi (kat %d, durum %d)\n", msg->floor+1, msg->status);
+        exit(EXIT_FAILURE);
+    }
+    ex->floor_done[msg->floor] = 1;
+    ex->floors_running--;
+    int64_t cost = 0; // Katın maliyeti yalnızca başarılı bildirimle deftere girer
+    for (int i = 0; i < job_programs[JOB_FLOOR].step_count; i++) {
+        post_floor_step(i, msg->floor, msg->material[i], msg->labor[i]);
+        event_log_emit(EVENT_COST, JOB_KIND_COUNT, 0, msg->floor, -1, job_programs[JOB_FLOOR].steps[i].category,
+                       msg->material[i], msg->labor[i]);
+        cost += msg->material[i] + msg->labor[i];
+    }
+    floor_reported_cost += cost / 100.0;
+    log_message(MSG_FLOOR_RECEIVED, msg->floor+1, (int)(cost / 100));
+    executor_complete(ex, graph_floor_node(msg->floor));
+}
+
+// Çıkmış kat süreçlerini toplar. Bildirmeden ölen sürecin katı yeniden dağıtılır, ölen kalıcı
+// işçinin yerine yenisi başlatılır. Kat süreçleri maliyeti bildirimle taşıdığından ölen denemenin
+// maliyeti deftere girmemiştir ve süreç maliyet dilimi tutmaz; yeniden yapılan kat bir kez ödenir.
+static void floor_recover(struct GraphExecutor *ex) {
+    int lost[MAX_FLOOR_PROCS];
+    int lost_count = 0;
+    int status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        int floor = -1;
+        if (ex->procs) {
+            for (int w = 0; w < ex->procs->count; w++) {
+                if (ex->procs->pids[w] != pid) continue;
+                floor = atomic_load(&shared_data->floor_worker_job[w]);
+                floor_worker_spawn(ex->procs, w);
+                break;
+            }
+        } else {
+            for (int f = 0; f < total_floors; f++) {
+                if (ex->floor_pid[f] != pid) continue;
+                ex->floor_pid[f] = 0;
+                floor = f;
+                break;
+            }
+        }
+        if (floor >= 0 && lost_count < MAX_FLOOR_PROCS) lost[lost_count++] = floor;
+    }
+    // Süreç bildirip çıktıysa mesajı kutudadır: yeniden dağıtmadan önce bekleyenleri oku
+    struct FloorMessage msg;
+    while (mailbox_wait(&shared_data->floor_mail, ex->floor_messages, &msg, 0) == 0) floor_received(ex, &msg);
+    for (int i = 0; i < lost_count; i++) {
+        int floor = lost[i];
+        if (ex->floor_done[floor]) continue;
+        ex->floors_running--;
+        floor_retries++;
+        log_message(MSG_FLOOR_CRASH, floor+1, ex->floor_attempts[floor] + 1);
+        floor_dispatch(ex, floor);
+    }
+}
+
+// Binayı gerçek zamanlı olarak süreçler ve thread'lerle inşa eden fonksiyon.
+// Düğümler grafa göre öncülleri biter bitmez serbest kalır: katlar ana süreçten ayrı süreçlere
+// dağıtılırken, kabası biten katların daireleri havuzda aynı anda ilerler.
+void run_wallclock_simulation(const struct TaskGraph *graph, struct WorkerPool *pool, struct FloorProcs *procs) {
+    struct GraphExecutor ex;
+    memset(&ex, 0, sizeof(ex));
+    ex.graph = graph;
+    ex.pool = pool;
+    ex.tasks = calloc(graph->node_count, sizeof(struct NodeTask));
+    ex.remaining = calloc(graph->node_count, sizeof(atomic_int));
+    ex.floor_queue = calloc(total_floors, sizeof(int));
+    ex.procs = procs;
+    ex.timer = task_timer_start(pool, graph->node_count);
+    delivery_desk_init(&ex);
+    ex.floor_pid = calloc(total_floors, sizeof(pid_t));
+    ex.floor_done = calloc(total_floors, 1);
+    ex.floor_attempts = calloc(total_floors, sizeof(int));
+    if (!ex.tasks || !ex.remaining || !ex.floor_queue || !ex.floor_pid || !ex.floor_done || !ex.floor_attempts) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    mailbox_reset(&shared_data->floor_mail); // Her bina kat bildirimlerini baştan sayar
+    memset(&floor_handoff_hist, 0, sizeof(floor_handoff_hist));
+    floor_reported_cost = 0.0;
+    floor_retries = 0;
+    pthread_mutex_init(&ex.lock, NULL);
+    pthread_cond_init(&ex.ready, NULL);
+    for (int n = 0; n < graph->node_count; n++) {
+        ex.tasks[n] = (struct NodeTask){ { node_step_task, NULL }, &ex, n, 0, STEP_ACQUIRE, 0 };
+        atomic_init(&ex.remaining[n], graph->indegree[n]);
+    }
+    atomic_init(&ex.nodes_left, graph->node_count);
+
+    for (int n = 0; n < graph->node_count; n++) { // Öncülü olmayan düğümler (temel atma)
+        if (graph->indegree[n] == 0) executor_release(&ex, n, -1);
+    }
+
+    // Ana süreç hazır katları dağıtır ve bildirimlerini bekler; tüm düğümler bitince döngüden çıkar
+    for (;;) {
+        pthread_mutex_lock(&ex.lock);
+        while (ex.queue_head == ex.queue_tail && ex.floors_running == 0 && atomic_load(&ex.nodes_left) > 0) {
+            pthread_cond_wait(&ex.ready, &ex.lock);
+        }
+        int ready[FLOOR_QUEUE_SLOTS / 2];
+        int ready_count = 0;
+        while (ex.queue_head < ex.queue_tail && ready_count < FLOOR_QUEUE_SLOTS / 2) {
+            ready[ready_count++] = ex.floor_queue[ex.queue_head++];
+        }
+        pthread_mutex_unlock(&ex.lock);
+        if (ready_count == 0 && ex.floors_running == 0) break;
+
+        for (int i = 0; i < ready_count; i++) floor_dispatch(&ex, graph->nodes[ready[i]].floor);
+        struct FloorMessage msg;
+        if (mailbox_wait(&shared_data->floor_mail, ex.floor_messages, &msg, FLOOR_POLL_MS) == 0) floor_received(&ex, &msg);
+        else floor_recover(&ex); // Uzun süredir bildirim yok: ölen kat süreci var mı bak
+    }
+    pool_wait(pool); // Son düğümü bitiren görevin dönmesini bekle
+    task_timer_stop(ex.timer);
+    pool_wait(pool); // Zamanlayıcının son gönderdikleri (asansör dönüşleri) masa yok edilmeden bitsin
+    if (!procs) {
+        for (int f = 0; f < total_floors; f++) { // Kat süreçlerinin çıkmasını bekle
+            if (ex.floor_pid[f] > 0) waitpid(ex.floor_pid[f], NULL, 0);
+        }
+    }
+
+    pthread_mutex_destroy(&ex.lock);
+    pthread_cond_destroy(&ex.ready);
+    pthread_mutex_destroy(&ex.delivery.lock);
+    free(ex.tasks);
+    free(ex.remaining);
+    free(ex.floor_queue);
+    free(ex.floor_pid);
+    free(ex.floor_done);
+    free(ex.floor_attempts);
+}
+
+// Aynı tohumla iki zamanlamayı sanal zamanda koşturup bitiş sürelerini karşılaştıran fonksiyon.
+// Gerçek modda bir sanal gün delay_scale saniye beklenir; beklenen gerçek süre bu çarpanla yazdırılır
+// (ölçülen değil, uyku sürelerinin toplamıdır; iş parçacığı ve fork gecikmeleri eklenmez).
+void print_schedule_comparison(double measured_ms) {
+    enum LogLevel saved = log_level;
+    log_level = LOG_LEVEL_QUIET; // Karşılaştırma koşuları günlüğe yazmaz
+    event_muted = 1;             // ve olay günlüğüne de
+    double makespan[2];
+    double compute_ms[2];
+    for (int m = 0; m < 2; m++) {
+        struct TaskGraph graph;
+        struct timespec t0, t1;
+        graph_build(&graph, (enum ScheduleMode)m);
+        random_stream(0);
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        makespan[m] = run_virtual_simulation(&graph, crew_counts, 0, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        compute_ms[m] = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+        graph_free(&graph);
+    }
+    log_level = saved;
+    event_muted = 0;
+
+    printf(COLOR_CYAN "\n=== ZAMANLAMA KARŞILAŞTIRMASI (aynı tohum) ===\n" COLOR_RESET);
+    printf("Zamanlama      | Bitiş (sanal gün) | Gerçek modda (sn) | Hesaplama (ms)\n");
+    printf("---------------|-------------------|-------------------|---------------\n");
+    for (int m = SCHEDULE_SERIAL; m >= SCHEDULE_PIPELINE; m--) {
+        printf("%s | %17.2f | %17.2f | %14.3f\n", schedule_labels[m], makespan[m], makespan[m] * delay_scale, compute_ms[m]);
+    }
+    printf("Boru hattı kazancı: %.2f gün (%%%.1f daha kısa)\n", makespan[SCHEDULE_SERIAL] - makespan[SCHEDULE_PIPELINE],
+           100.0 * (1.0 - makespan[SCHEDULE_PIPELINE] / makespan[SCHEDULE_SERIAL]));
+    if (delay_scale != 1.0) printf("Gerçek modda süreler --delay-scale=%g ile çarpılmıştır\n", delay_scale);
+    printf("Bu çalıştırma (%s): %.2f ms\n", schedule_names[schedule_mode], measured_ms);
+}
+
+// Aynı tohumla tek tek ve toplu malzeme taşımayı sanal zamanda koşturup asansör verimini,
+// kuyruk beklemelerini ve bitiş sürelerini karşılaştıran fonksiyon
+void print_delivery_comparison(void) {
+    enum LogLevel saved_level = log_level;
+    enum DeliveryMode saved_mode = delivery_mode;
+    log_level = LOG_LEVEL_QUIET;
+    event_muted = 1;
+    struct SimResult result[2];
+    struct TaskGraph graph;
+    graph_build(&graph, schedule_mode);
+    for (int m = 0; m < 2; m++) {
+        delivery_mode = (enum DeliveryMode)m;
+        random_stream(0);
+        run_virtual_simulation(&graph, crew_counts, 0, &result[m]);
+    }
+    graph_free(&graph);
+    delivery_mode = saved_mode;
+    log_level = saved_level;
+    event_muted = 0;
+
+    printf(COLOR_CYAN "\n=== MALZEME TAŞIMA (aynı tohum, %d asansör) ===\n" COLOR_RESET, crew_counts[RES_ELEVATOR]);
+    printf("Politika              | Asansörle | Merdivenle | Sefer | Sefer başına | Teslimat/saat | Teslimat/meşgul asansör-saat | Ort. bekleme (sa) | En uzun (sa) | Bitiş (gün)\n");
+    printf("----------------------|-----------|------------|-------|--------------|---------------|------------------------------|-------------------|--------------|------------\n");
+    for (int m = DELIVERY_SINGLE; m >= DELIVERY_BATCH; m--) {
+        const struct DeliveryStats *d = &result[m].delivery;
+        char label[32];
+        if (m == DELIVERY_SINGLE) snprintf(label, sizeof(label), "Tek tek");
+        else if (delivery_hold > 0.0) snprintf(label, sizeof(label), "Toplu (k%d, bekl %.2f)", elevator_capacity, delivery_hold);
+        else snprintf(label, sizeof(label), "Toplu (kapasite %d)", elevator_capacity);
+        print_padded(label, 22);
+        printf("| %9lu | %10lu | %5lu | %12.2f | %13.3f | %28.2f | %17.2f | %12.2f | %11.2f\n", d->by_elevator, d->by_stairs,
+               d->trips, d->trips > 0 ? (double)d->by_elevator / d->trips : 0.0,
+               result[m].makespan > 0.0 ? (d->by_elevator + d->by_stairs) / (result[m].makespan * 24.0) : 0.0, // Simüle edilen saat başına
+               d->elevator_days > 0.0 ? d->by_elevator / (d->elevator_days * 24.0) : 0.0,
+               d->by_elevator > 0 ? d->wait_days * 24.0 / d->by_elevator : 0.0, d->max_wait_days * 24.0, result[m].makespan);
+    }
+    const struct DeliveryStats *single = &result[DELIVERY_SINGLE].delivery, *batch = &result[DELIVERY_BATCH].delivery;
+    double wait_gain = (single->by_elevator > 0 ? single->wait_days / single->by_elevator : 0.0) -
+                       (batch->by_elevator > 0 ? batch->wait_days / batch->by_elevator : 0.0);
+    double finish_gain = result[DELIVERY_SINGLE].makespan - result[DELIVERY_BATCH].makespan;
+    printf("Toplu taşıma: ortalama bekleme %.2f saat %s, bitiş %.2f gün %s\n", (wait_gain < 0 ? -wait_gain : wait_gain) * 24.0,
+           wait_gain >= 0 ? "daha kısa" : "daha uzun", finish_gain < 0 ? -finish_gain : finish_gain,
+           finish_gain >= 0 ? "daha erken" : "daha geç");
+}
+
+// Toplu (Monte Carlo) koşudaki bir kopya
+struct ReplicaTask {
+    struct PoolTask task;            // Havuz görevi (ilk üye)
+    const struct TaskGraph *graph;   // Tüm kopyaların paylaştığı graf (salt okunur)
+    long index;                      // Kopya numarası (aynı zamanda rastgele akış numarası)
+    struct SimResult result;         // Koşunun sonucu
+};
+
+// Kopya görevi: kendi akışıyla binayı sanal zamanda baştan sona simüle eder
+static void replica_task(struct PoolTask *task) {
+    struct ReplicaTask *t = (struct ReplicaTask *)task;
+    random_stream((uint64_t)t->index); // Sonuç hangi işçide koştuğundan bağımsızdır
+    event_replica = (uint32_t)t->index;
+    run_virtual_simulation(t->graph, crew_counts, 0, &t->result);
+}
+
+// qsort için double karşılaştırması
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Sıralı dizide en yakın sıra yöntemiyle q yüzdeliğini döndürür
+static double percentile(const double *sorted, long n, double q) {
+    long rank = (long)(q * n);
+    if (rank < q * n) rank++; // Yukarı yuvarla
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+// Dağılımın tablo satırını yazdırır (values sıralanır)
+static void print_distribution_row(const char *label, double *values, long n) {
+    double sum = 0.0;
+    for (long i = 0; i < n; i++) sum += values[i]; // Kopya sırasıyla topla (tekrarlanabilir)
+    qsort(values, n, sizeof(double), compare_double);
+    printf("%s | %14.2f | %14.2f | %14.2f | %14.2f\n", label,
+           percentile(values, n, 0.50), percentile(values, n, 0.90), percentile(values, n, 0.99), sum / n);
+}
+
+// Monte Carlo toplu modu: N bağımsız kopyayı iş havuzunda paralel koşturur, bitiş süresi
+// ve toplam maliyet yüzdeliklerini yazdırır. Her kopya ana tohumun kendi akışını kullandığından
+// sonuçlar aynı tohum ve kopya sayısı için işçi sayısından bağımsız olarak bit düzeyinde aynıdır.
+void run_batch(long replicas) {
+    run_mode = MODE_VIRTUAL;
+    enum LogLevel saved = log_level;
+    log_level = LOG_LEVEL_QUIET; // Kopyalar günlüğe yazmaz
+
+    struct TaskGraph graph;
+    graph_build(&graph, schedule_mode);
+    struct ReplicaTask *tasks = calloc(replicas, sizeof(struct ReplicaTask));
+    double *makespans = malloc(replicas * sizeof(double));
+    double *costs = malloc(replicas * sizeof(double));
+    if (!tasks || !makespans || !costs) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    if (event_log) event_log->replicas = (int32_t)replicas;
+    struct WorkerPool *pool = pool_create(pool_workers); // Koşular işlemci bağımlı: işlemci sayısı kadar işçi
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long i = 0; i < replicas; i++) {
+        tasks[i] = (struct ReplicaTask){ { replica_task, NULL }, &graph, i, { 0.0, 0.0, 0.0, 0, { 0 } } };
+        pool_submit(pool, &tasks[i].task);
+    }
+    pool_wait(pool);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    int workers = pool->worker_count;
+    pool_destroy(pool);
+    log_level = saved;
+
+    // Sonuçların özeti: aynı tohum ve kopya sayısıyla tekrar çalıştırıldığında aynı olmalı
+    uint64_t digest = 0xCBF29CE484222325ULL; // FNV-1a
+    for (long i = 0; i < replicas; i++) {
+        makespans[i] = tasks[i].result.makespan;
+        costs[i] = tasks[i].result.total_cost;
+        uint64_t bits[2];
+        memcpy(&bits[0], &makespans[i], sizeof(double));
+        memcpy(&bits[1], &costs[i], sizeof(double));
+        for (int b = 0; b < 2; b++) digest = (digest ^ bits[b]) * 0x100000001B3ULL;
+    }
+    double elapsed_ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+
+    printf(COLOR_GREEN "\n%d KATLI APARTMAN MONTE CARLO TOPLU SİMÜLASYONU\n" COLOR_RESET, total_floors);
+    printf("Bina: %d kat x %d daire, zamanlama: %s\n", total_floors, apartments_per_floor, schedule_names[schedule_mode]);
+    printf("Tohum: %llu, kopya: %ld, işçi: %d\n", (unsigned long long)run_seed, replicas, workers);
+    printf(COLOR_CYAN "\n=== SONUÇ DAĞILIMI ===\n" COLOR_RESET);
+    printf("Ölçü                |            p50 |            p90 |            p99 |       Ortalama\n");
+    printf("--------------------|----------------|----------------|----------------|---------------\n");
+    print_distribution_row("Bitiş (sanal gün)  ", makespans, replicas);
+    print_distribution_row("Toplam maliyet (TL)", costs, replicas);
+    printf("Hesaplama süresi: %.2f ms (%.0f kopya/sn)\n", elapsed_ms, replicas / (elapsed_ms / 1e3));
+    printf("Sonuç özeti: %016llx\n", (unsigned long long)digest);
+
+    graph_free(&graph);
+    free(tasks);
+    free(makespans);
+    free(costs);
+}
+
+// Portföydeki bir bölge: şantiyeleri bölgenin ekip ve asansör havuzunu paylaşır
+struct RegionTask {
+    struct PoolTask task;            // Havuz görevi (ilk üye)
+    const struct TaskGraph *graph;   // Her şantiyenin grafı (salt okunur, tüm şantiyeler aynı bina)
+    int region;                      // Bölge numarası (aynı zamanda rastgele akış numarası)
+    int site_count;                  // Bölgedeki şantiye sayısı
+    double *site_finish;             // Bölgenin şantiyelerinin bitişleri (portföy dizisinin dilimi)
+    double *site_cost;               // Bölgenin şantiyelerinin yapım maliyetleri
+    struct SimResult result;         // Bölgenin bitişi ve maliyeti (ekip günlükleri dahil)
+    unsigned long travels;           // Şantiye değiştiren ekip sayısı
+};
+
+// Bölge görevi: bölgenin tüm şantiyelerini tek olay döngüsünde, paylaşılan ekiplerle simüle eder.
+// Bölgeler ortak durum paylaşmadığından görevler kilitsiz ve paralel koşar.
+static void region_task(struct PoolTask *task) {
+    struct RegionTask *t = (struct RegionTask *)task;
+    random_stream((uint64_t)t->region); // Sonuç hangi işçide koştuğundan bağımsızdır
+    event_muted = 1;                    // Olay günlüğü tek bina içindir
+    struct Simulation sim;
+    sim_setup(&sim, t->graph, crew_counts, 0, t->site_count);
+    sim.travel_days = travel_days;
+    sim.site_finish = t->site_finish;
+    sim.site_cost = t->site_cost;
+    sim_start(&sim);
+    while (sim.heap_size > 0) {
+        struct SimEvent ev = sim_pop(&sim);
+        virtual_now = ev.time;
+        sim.events_processed++;
+        sim_handle_event(&sim, ev.job);
+    }
+    double crew = crew_cost(crew_counts, virtual_now); // Bölgenin ekipleri son şantiye bitene kadar ödenir
+    t->result = (struct SimResult){ virtual_now, sim.total_cost + crew, crew, sim.events_processed, sim.delivery };
+    t->travels = sim.travels;
+    sim_teardown(&sim);
+}
+
+// Portföy modu (--sites=N): N aynı bina, --regions ile bölgelere ayrılır. Her bölgenin kendi
+// --crews havuzu vardır; ekip başka şantiyeye geçerken --travel-days kadar yolda kalır.
+// Şantiye ve bölge bitişleri ile portföyün bitişi ve maliyeti yazdırılır.
+void run_portfolio(int sites) {
+    run_mode = MODE_VIRTUAL;
+    enum LogLevel saved = log_level;
+    log_level = LOG_LEVEL_QUIET; // Şantiyeler günlüğe yazmaz
+
+    struct TaskGraph graph;
+    graph_build(&graph, schedule_mode);
+    int regions = portfolio_regions;
+    struct RegionTask *tasks = calloc(regions, sizeof(struct RegionTask));
+    double *site_finish = calloc(sites, sizeof(double));
+    double *site_cost = calloc(sites, sizeof(double));
+    if (!tasks || !site_finish || !site_cost) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    struct WorkerPool *pool = pool_create(pool_workers);
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < regions; r++) { // Şantiyeler bölgelere ardışık dilimler halinde dağılır
+        int first = (int)((long)r * sites / regions), last = (int)((long)(r + 1) * sites / regions);
+        tasks[r] = (struct RegionTask){ { region_task, NULL }, &graph, r, last - first,
+                                        site_finish + first, site_cost + first, { 0.0, 0.0, 0.0, 0, { 0 } }, 0 };
+        pool_submit(pool, &tasks[r].task);
+    }
+    pool_wait(pool);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    int workers = pool->worker_count;
+    pool_destroy(pool);
+    log_level = saved;
+    double elapsed_ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+
+    printf(COLOR_GREEN "\n%d ŞANTİYELİ PORTFÖY SİMÜLASYONU\n" COLOR_RESET, sites);
+    printf("Şantiye: %d kat x %d daire, zamanlama: %s, tohum: %llu\n", total_floors, apartments_per_floor,
+           schedule_names[schedule_mode], (unsigned long long)run_seed);
+    printf("Bölge: %d, bölge başına ekipler: elektrik %d, sıhhi tesisat %d, boya %d, asansör %d; şantiyeler arası yol %.2f gün\n",
+           regions, crew_counts[RES_ELECTRIC], crew_counts[RES_PLUMBING], crew_counts[RES_PAINT],
+           crew_counts[RES_ELEVATOR], travel_days);
+
+    printf(COLOR_CYAN "\n=== ŞANTİYELER ===\n" COLOR_RESET);
+    printf("Şantiye | Bölge | Bitiş (gün) | Yapım maliyeti (TL)\n");
+    printf("--------|-------|-------------|--------------------\n");
+    double build_cost = 0.0, finish_sum = 0.0;
+    for (int r = 0; r < regions; r++) {
+        int first = (int)(tasks[r].site_finish - site_finish);
+        for (int i = 0; i < tasks[r].site_count; i++) {
+            printf("%7d | %5d | %11.2f | %19.2f\n", first + i + 1, r + 1, site_finish[first + i], site_cost[first + i]);
+            build_cost += site_cost[first + i];
+            finish_sum += site_finish[first + i];
+        }
+    }
+
+    printf(COLOR_CYAN "\n=== BÖLGELER ===\n" COLOR_RESET);
+    printf("Bölge | Şantiye | Bitiş (gün) | Ekip günlükleri (TL) | Şantiye değişimi |     Olay\n");
+    printf("------|---------|-------------|----------------------|------------------|---------\n");
+    double makespan = 0.0, crew_total = 0.0;
+    uint64_t digest = 0xCBF29CE484222325ULL; // FNV-1a
+    for (int r = 0; r < regions; r++) {
+        const struct SimResult *res = &tasks[r].result;
+        printf("%5d | %7d | %11.2f | %20.2f | %16lu | %8lu\n", r + 1, tasks[r].site_count, res->makespan,
+               res->crew_cost, tasks[r].travels, res->events);
+        if (res->makespan > makespan) makespan = res->makespan;
+        crew_total += res->crew_cost;
+        uint64_t bits[2];
+        memcpy(&bits[0], &res->makespan, sizeof(double));
+        memcpy(&bits[1], &res->total_cost, sizeof(double));
+        for (int b = 0; b < 2; b++) digest = (digest ^ bits[b]) * 0x100000001B3ULL;
+    }
+
+    printf(COLOR_CYAN "\n=== PORTFÖY ===\n" COLOR_RESET);
+    printf("Portföy bitişi: %.2f gün (şantiye ortalaması %.2f gün)\n", makespan, finish_sum / sites);
+    printf("Toplam maliyet: %.2f TL (yapım %.2f TL, ekip günlükleri %.2f TL)\n", build_cost + crew_total, build_cost, crew_total);
+    printf("Hesaplama süresi: %.2f ms (%d işçi)\n", elapsed_ms, workers);
+    printf("Sonuç özeti: %016llx\n", (unsigned long long)digest);
+
+    graph_free(&graph);
+    free(tasks);
+    free(site_finish);
+    free(site_cost);
+}
+
+// Ekip eniyilemesinde denenen bir yerleşim
+struct TuneTask {
+    struct PoolTask task;            // Havuz görevi (ilk üye)
+    const struct TaskGraph *graph;   // Tüm yerleşimlerin paylaştığı graf (salt okunur)
+    int crews[RES_COUNT];            // Kaynak başına ekip sayısı
+    long replicas;                   // Yerleşim başına kopya sayısı
+    double makespan;                 // Ortalama bitiş (gün)
+    double total_cost;               // Ortalama toplam maliyet (TL)
+    double crew_cost;                // Ortalama ekip günlükleri (TL)
+};
+
+// Yerleşim görevi: kopyaları sırayla koşturup ortalamaları hesaplar
+static void tune_task(struct PoolTask *task) {
+    struct TuneTask *t = (struct TuneTask *)task;
+    event_muted = 1; // Denenen yerleşimler olay günlüğüne yazmaz
+    for (long i = 0; i < t->replicas; i++) {
+        struct SimResult result;
+        random_stream((uint64_t)i); // Ortak rastgele sayılar: her yerleşim aynı akışlarla denenir
+        run_virtual_simulation(t->graph, t->crews, 0, &result);
+        t->makespan += result.makespan;
+        t->total_cost += result.total_cost;
+        t->crew_cost += result.crew_cost;
+    }
+    t->makespan /= t->replicas;
+    t->total_cost /= t->replicas;
+    t->crew_cost /= t->replicas;
+}
+
+// qsort için yerleşim karşılaştırması: önce bitiş süresi, sonra maliyet
+static int compare_tune(const void *a, const void *b) {
+    const struct TuneTask *x = *(const struct TuneTask *const *)a, *y = *(const struct TuneTask *const *)b;
+    if (x->makespan != y->makespan) return (x->makespan > y->makespan) - (x->makespan < y->makespan);
+    return (x->total_cost > y->total_cost) - (x->total_cost < y->total_cost);
+}
+
+// Yerleşimin ekip sayılarını ve sonuçlarını yazdırır
+static void print_tune_row(const struct TuneTask *t, const char *mark) {
+    printf("%8d | %13d | %4d | %7d | %11.2f | %17.2f | %19.2f%s%s\n", t->crews[RES_ELECTRIC], t->crews[RES_PLUMBING],
+           t->crews[RES_PAINT], t->crews[RES_ELEVATOR], t->makespan, t->crew_cost, t->total_cost, *mark ? " " : "", mark);
+}
+
+// Ekip eniyilemesi: her kaynak için 1..max_crews ekibin tüm bileşimlerini sanal zamanda iş havuzunda
+// koşturur ve bitiş süresi ile toplam maliyetin Pareto sınırını yazdırır. Sınırdaki bir yerleşimden
+// hem daha kısa hem daha ucuz başka yerleşim yoktur.
+void run_tune(int max_crews) {
+    run_mode = MODE_VIRTUAL;
+    enum LogLevel saved = log_level;
+    log_level = LOG_LEVEL_QUIET; // Koşular günlüğe yazmaz
+
+    long configs = 1;
+    for (int r = 0; r < RES_COUNT; r++) configs *= max_crews;
+    long replicas = batch_replicas > 0 ? batch_replicas : 8;
+    struct TaskGraph graph;
+    graph_build(&graph, schedule_mode);
+    struct TuneTask *tasks = calloc(configs + 1, sizeof(struct TuneTask)); // Sonuncusu şu anki yerleşim
+    struct TuneTask **order = malloc((configs + 1) * sizeof(struct TuneTask *));
+    if (!tasks || !order) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    struct WorkerPool *pool = pool_create(pool_workers);
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long c = 0; c <= configs; c++) {
+        struct TuneTask *t = &tasks[c];
+        *t = (struct TuneTask){ { tune_task, NULL }, &graph, { 0 }, replicas, 0.0, 0.0, 0.0 };
+        long digits = c;
+        for (int r = 0; r < RES_COUNT; r++) { // c'nin max_crews tabanındaki basamakları
+            t->crews[r] = c < configs ? (int)(digits % max_crews) + 1 : crew_counts[r];
+            digits /= max_crews;
+        }
+        pool_submit(pool, &t->task);
+    }
+    pool_wait(pool);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    int workers = pool->worker_count;
+    pool_destroy(pool);
+    log_level = saved;
+
+    for (long c = 0; c < configs; c++) order[c] = &tasks[c];
+    qsort(order, configs, sizeof(struct TuneTask *), compare_tune);
+    const struct TuneTask *current = &tasks[configs];
+
+    printf(COLOR_GREEN "\n%d KATLI APARTMAN EKİP ENİYİLEMESİ\n" COLOR_RESET, total_floors);
+    printf("Bina: %d kat x %d daire, zamanlama: %s\n", total_floors, apartments_per_floor, schedule_names[schedule_mode]);
+    printf("Ekip-gün ücreti (TL): elektrik %.2f, sıhhi tesisat %.2f, boya %.2f, asansör %.2f\n", crew_day_costs[RES_ELECTRIC],
+           crew_day_costs[RES_PLUMBING], crew_day_costs[RES_PAINT], crew_day_costs[RES_ELEVATOR]);
+    printf("Tohum: %llu, yerleşim: %ld (kaynak başına 1..%d ekip), yerleşim başına %ld kopya, işçi: %d\n",
+           (unsigned long long)run_seed, configs, max_crews, replicas, workers);
+    printf(COLOR_CYAN "\n=== PARETO SINIRI (bitiş süresi ve toplam maliyet, kopya ortalaması) ===\n" COLOR_RESET);
+    printf("Elektrik | Sıhhi tesisat | Boya | Asansör | Bitiş (gün) | Ekip günlüğü (TL) | Toplam maliyet (TL)\n");
+    printf("---------|---------------|------|---------|-------------|-------------------|--------------------\n");
+    double best_cost = 0.0;
+    const struct TuneTask *dominating = NULL; // Şu ankinden hem kısa hem ucuz sınır noktalarının en ucuzu
+    int frontier = 0;
+    for (long c = 0; c < configs; c++) {
+        const struct TuneTask *t = order[c];
+        if (frontier > 0 && t->total_cost >= best_cost) continue; // Daha kısa ve ucuz bir yerleşim var
+        best_cost = t->total_cost;
+        frontier++;
+        int same = memcmp(t->crews, current->crews, sizeof(t->crews)) == 0;
+        print_tune_row(t, same ? "<- şu anki" : "");
+        if (!same && t->makespan <= current->makespan && t->total_cost <= current->total_cost) dominating = t;
+    }
+    printf("Sınırdaki yerleşim: %d / %ld, hesaplama süresi: %.2f ms\n", frontier, configs,
+           (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+    printf("Şu anki yerleşim (%d, %d, %d, %d): %.2f gün, %.2f TL\n", current->crews[RES_ELECTRIC],
+           current->crews[RES_PLUMBING], current->crews[RES_PAINT], current->crews[RES_ELEVATOR],
+           current->makespan, current->total_cost);
+    if (dominating) { // Sınırda süre arttıkça maliyet azaldığından son bulunan en ucuzudur
+        printf("Daha iyisi: (%d, %d, %d, %d) ile %.2f gün daha kısa ve %.2f TL daha ucuz\n",
+               dominating->crews[RES_ELECTRIC], dominating->crews[RES_PLUMBING], dominating->crews[RES_PAINT],
+               dominating->crews[RES_ELEVATOR], current->makespan - dominating->makespan,
+               current->total_cost - dominating->total_cost);
+    }
+
+    graph_free(&graph);
+    free(tasks);
+    free(order);
+}
+
+// Dilimlerdeki fiyat kalemi miktarlarını toplar
+static void ledger_quantities(double *quantity) {
+    memset(quantity, 0, MAX_PRICE_ITEMS * sizeof(double));
+    for (int i = 0; i <= COST_SHARDS; i++) {
+        const struct CostShard *shard = i < COST_SHARDS ? &shared_data->shards[i] : &shared_data->overflow;
+        for (int q = 0; q < price_item_count; q++) quantity[q] += atomic_load_explicit(&shard->quantity[q], memory_order_relaxed);
+    }
+}
+
+// Defterin adım kategorileri, her kalemin double fiyatından kuruşa yuvarlanan adım tutarı ile adım
+// sayısının çarpımına kuruşu kuruşuna eşit olmalı (ara hesapta float kalırsa kuruş kaybolur)
+static int ledger_matches_prices(const int64_t *material, const int64_t *labor) {
+    double quantity[MAX_PRICE_ITEMS];
+    ledger_quantities(quantity);
+    int64_t expect_material[CAT_COUNT] = { 0 }, expect_labor[CAT_COUNT] = { 0 };
+    for (int k = 0; k < JOB_KIND_COUNT; k++) {
+        for (int i = 0; i < job_programs[k].step_count; i++) {
+            const struct TaskStep *step = &job_programs[k].steps[i];
+            int64_t count = (int64_t)(quantity[price_item(k, i)] / step_quantity(step) + 0.5);
+            int64_t unit = kurus_round(prices.material[price_item(k, i)] * step_quantity(step) * 100.0);
+            expect_material[step->category] += count * unit;
+            expect_labor[step->category] += count * kurus_round(unit * prices.labor_ratio[step->category]);
+        }
+    }
+    for (int c = 0; c < CAT_COUNT; c++) {
+        if (c != CAT_CREW && (material[c] != expect_material[c] || labor[c] != expect_labor[c])) return 0;
+    }
+    return 1;
+}
+
+// Maliyet özetini yazdıran fonksiyon; sütun toplamları kuruş üzerinden tamsayıyla alınır
+void print_cost_summary() {
+    int64_t material[CAT_COUNT], labor[CAT_COUNT];
+    cost_totals_kurus(material, labor); // Dilimleri yalnızca burada topla
+
+    printf(COLOR_CYAN "\n=== MALİYET ÖZETİ ===\n" COLOR_RESET);
+    printf("Kategori                | Malzeme Maliyeti | İşçilik Maliyeti | Toplam\n");
+    printf("------------------------|------------------|------------------|------------\n");
+    // Her kategori için malzeme, işçilik ve toplam maliyetleri yazdır
+    int64_t total_material = 0, total_labor = 0;
+    for (int c = 0; c < CAT_COUNT; c++) {
+        printf("%s | %.2f TL         | %.2f TL         | %.2f TL\n", category_labels[c],
+               material[c] / 100.0, labor[c] / 100.0, (material[c] + labor[c]) / 100.0);
+        total_material += material[c];
+        total_labor += labor[c];
+    }
+    printf("------------------------|------------------|------------------|------------\n");
+    printf("TOPLAM                 | %.2f TL         | %.2f TL         | %.2f TL\n",
+           total_material / 100.0, total_labor / 100.0, (total_material + total_labor) / 100.0);
+    printf("Defter, birim fiyat x adım sayısı ile: %s\n", ledger_matches_prices(material, labor) ? "tam uyuşuyor" : "UYUŞMUYOR");
+}
+
+// Defterdeki miktarları verilen fiyatlarla yeniden fiyatlar: dilimlerin miktarlarını toplar ve her
+// kalemi defterin yuvarladığı gibi fiyatlar: adımın bir kezlik kuruş tutarı defterle aynı yardımcıdan
+// (step_cost_with) alınır, adım sayısıyla çarpılır. Fiyatlar değişmemişse sonuç defterle
+// kuruşu kuruşuna aynıdır; koşu tekrarlanmaz
+void recost(const struct PriceTable *table, struct CostTotals *out) {
+    double quantity[MAX_PRICE_ITEMS];
+    ledger_quantities(quantity);
+    int64_t material[CAT_COUNT] = { 0 }, labor[CAT_COUNT] = { 0 };
+    for (int k = 0; k < JOB_KIND_COUNT; k++) {
+        for (int i = 0; i < job_programs[k].step_count; i++) {
+            const struct TaskStep *step = &job_programs[k].steps[i];
+            int64_t count = (int64_t)(quantity[price_item(k, i)] / step_quantity(step) + 0.5); // Adımın yapılma sayısı
+            int64_t step_material, step_labor;
+            step_cost_with(table, k, i, &step_material, &step_labor); // Defterin adım başına tutarı
+            material[step->category] += count * step_material;
+            labor[step->category] += count * step_labor;
+        }
+    }
+    double crew = 0.0; // Ekip günlükleri deftere tek kayıtla girer
+    for (int r = 0; r < RES_COUNT; r++) crew += crew_days[r] * table->crew_day[r];
+    labor[CAT_CREW] += to_kurus(crew);
+    out->total = 0.0;
+    int64_t total = 0;
+    for (int c = 0; c < CAT_COUNT; c++) {
+        out->material[c] = material[c] / 100.0;
+        out->labor[c] = labor[c] / 100.0;
+        total += material[c] + labor[c];
+    }
+    out->total = total / 100.0;
+}
+
+static const char *what_if_paths[8];     // --what-if ile verilen fiyat dosyaları
+static struct PriceTable what_if_changes[8]; // Dosyalardaki değişiklikler (-1: dosyada verilmemiş)
+static int what_if_count;                // Verilen dosya sayısı
+static int what_if_report;               // --what-if verildi: duyarlılık raporu yazdırılır
+
+void load_prices(const char *path, struct PriceTable *table);
+
+// --what-if dosyalarını koşudan önce okur: hatalı anahtar ya da satır simülasyon başlamadan bildirilir.
+// Dosyada verilmeyen alanlar -1 kalır (fiyat dosyası negatif değer kabul etmez)
+void load_what_if_files(void) {
+    for (int w = 0; w < what_if_count; w++) {
+        struct PriceTable *changes = &what_if_changes[w];
+        for (int q = 0; q < MAX_PRICE_ITEMS; q++) changes->material[q] = -1.0;
+        for (int c = 0; c < CAT_COUNT; c++) changes->labor_ratio[c] = -1.0;
+        for (int r = 0; r < RES_COUNT; r++) changes->crew_day[r] = -1.0;
+        load_prices(what_if_paths[w], changes);
+    }
+}
+
+// Dosyanın değişikliklerini fiyat tablosunun üzerine yazar
+static void apply_what_if(struct PriceTable *table, const struct PriceTable *changes) {
+    for (int q = 0; q < price_item_count; q++) {
+        if (changes->material[q] >= 0.0) table->material[q] = changes->material[q];
+    }
+    for (int c = 0; c < CAT_COUNT; c++) {
+        if (changes->labor_ratio[c] >= 0.0) table->labor_ratio[c] = changes->labor_ratio[c];
+    }
+    for (int r = 0; r < RES_COUNT; r++) {
+        if (changes->crew_day[r] >= 0.0) table->crew_day[r] = changes->crew_day[r];
+    }
+}
+
+// Duyarlılık satırı: değişikliğin toplamını ve temel toplama göre farkını yazdırır
+static void print_what_if_row(const char *label, const struct PriceTable *table, double base) {
+    struct CostTotals totals;
+    recost(table, &totals);
+    print_padded(label, 38);
+    printf(" | %16.2f | %+14.2f (%+.2f%%)\n", totals.total, totals.total - base,
+           base > 0.0 ? 100.0 * (totals.total - base) / base : 0.0);
+}
+
+// Maliyet duyarlılığı: fiyat değişikliklerinin etkisini defterdeki miktarlardan hesaplar
+void print_what_if_report(void) {
+    struct PriceTable base = prices;
+    for (int r = 0; r < RES_COUNT; r++) base.crew_day[r] = crew_day_costs[r]; // Komut satırı ücretleri
+    struct CostTotals totals;
+    uint64_t start = monotonic_ns(); // Tek geçiş; tekrarlı ölçüm --bench=recost'tadır
+    recost(&base, &totals);
+    double recost_us = (monotonic_ns() - start) / 1e3;
+
+    printf(COLOR_CYAN "\n=== MALİYET DUYARLILIĞI (koşu tekrarlanmadan) ===\n" COLOR_RESET);
+    printf("Miktarlardan hesaplanan toplam: %.2f TL (defter %.2f TL), yeniden hesaplama %.2f µs\n",
+           totals.total, current_total_cost(), recost_us);
+    printf("Değişiklik                             | Toplam maliyet   | Fark\n");
+    printf("---------------------------------------|------------------|---------------------------\n");
+    char label[96];
+    for (int c = 0; c < CAT_COUNT; c++) { // Kategorinin tüm kalemlerinin fiyatı %10 artarsa
+        if (c == CAT_CREW || totals.material[c] <= 0.0) continue;
+        struct PriceTable table = base;
+        for (int k = 0; k < JOB_KIND_COUNT; k++) {
+            for (int i = 0; i < job_programs[k].step_count; i++) {
+                if (job_programs[k].steps[i].category == (enum CostCategory)c) table.material[price_item(k, i)] *= 1.1;
+            }
+        }
+        int len = (int)strlen(category_labels[c]);
+        while (len > 0 && category_labels[c][len - 1] == ' ') len--; // Hizalama boşluklarını at
+        snprintf(label, sizeof(label), "%.*s fiyatı +%%10", len, category_labels[c]);
+        print_what_if_row(label, &table, totals.total);
+    }
+    struct PriceTable table = base;
+    for (int c = 0; c < CAT_COUNT; c++) table.labor_ratio[c] += 0.1;
+    print_what_if_row("İşçilik oranları +0.10", &table, totals.total);
+    table = base;
+    for (int r = 0; r < RES_COUNT; r++) table.crew_day[r] *= 1.1;
+    print_what_if_row("Ekip-gün ücretleri +%10", &table, totals.total);
+    for (int w = 0; w < what_if_count; w++) { // Dosyadaki fiyatlar koşunun fiyatlarının üzerine yazılır
+        table = base;
+        apply_what_if(&table, &what_if_changes[w]);
+        snprintf(label, sizeof(label), "Dosya: %s", what_if_paths[w]);
+        print_what_if_row(label, &table, totals.total);
+    }
+}
+
+// Kaynak kullanımı ve kuyruk raporu: thread sayaçlarını birleştirir, kullanım oranını
+// (toplam tutma / (çalışma süresi x ekip sayısı)) ve bekleme dağılımını yazdırır. elapsed_ticks ölçüm
+// biriminde (gerçek modda ns, sanal modda simüle edilen saniye) toplam çalışma süresidir.
+void print_resource_report(double elapsed_ticks) {
+    struct ResourceStats *total = calloc(1, sizeof(struct ResourceStats));
+    if (!total) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    pthread_mutex_lock(&resource_stats_lock);
+    for (struct ResourceStats *st = resource_stats_list; st; st = st->next) {
+        for (int r = 0; r < RES_COUNT; r++) {
+            hist_merge(&total->wait[r], &st->wait[r]);
+            hist_merge(&total->hold[r], &st->hold[r]);
+            total->contended[r] += st->contended[r];
+        }
+    }
+    pthread_mutex_unlock(&resource_stats_lock);
+
+    int is_virtual = run_mode == MODE_VIRTUAL;
+    double per_unit = is_virtual ? SIM_TICKS_PER_DAY : 1e6; // Gösterim birimi: gün ya da ms
+    const char *unit = is_virtual ? "gün" : "ms";
+
+    printf(COLOR_CYAN "\n=== KAYNAK KULLANIMI VE KUYRUKLAR (süreler %s) ===\n" COLOR_RESET, unit);
+    printf("Kaynak              | Ekip | Kullanım | Edinme | Bekleyen | Ort. bekleme |   p50   |   p90   |   p99   | En uzun | Ort. tutma\n");
+    printf("--------------------|------|----------|--------|----------|--------------|---------|---------|---------|---------|-----------\n");
+    int worst = -1;
+    double capacity[RES_COUNT];
+    for (int r = 0; r < RES_COUNT; r++) {
+        const struct Histogram *w = &total->wait[r], *h = &total->hold[r];
+        capacity[r] = elapsed_ticks * crew_counts[r];
+        double utilization = capacity[r] > 0 ? 100.0 * h->sum / capacity[r] : 0.0;
+        double contended = w->count ? 100.0 * total->contended[r] / w->count : 0.0;
+        printf("%s | %4d | %7.1f%% | %6llu | %7.1f%% | %12.3f | %7.3f | %7.3f | %7.3f | %7.3f | %10.3f\n",
+               resource_labels[r], crew_counts[r], utilization, (unsigned long long)w->count, contended,
+               w->count ? w->sum / per_unit / w->count : 0.0,
+               hist_percentile(w, 0.50) / per_unit, hist_percentile(w, 0.90) / per_unit,
+               hist_percentile(w, 0.99) / per_unit, w->max / per_unit,
+               h->count ? h->sum / per_unit / h->count : 0.0);
+        if (w->sum > 0 && (worst < 0 || w->sum > total->wait[worst].sum)) worst = r;
+    }
+    if (worst >= 0) { // En çok toplam bekleme yaratan kaynak, ekip eklemede ilk adaydır
+        printf("Önce eklenecek: %s (toplam bekleme %.3f %s, kullanım %%%.1f)\n", resource_names[worst],
+               total->wait[worst].sum / per_unit, unit,
+               capacity[worst] > 0 ? 100.0 * total->hold[worst].sum / capacity[worst] : 0.0);
+    } else {
+        printf("Hiçbir kaynakta bekleme olmadı.\n");
+    }
+    free(total);
+}
+
+// İz olayının görünen adını yazar
+static void trace_event_name(char *buf, size_t size, const struct TraceEvent *ev) {
+    switch (ev->what) {
+    case TRACE_JOB:
+        switch (ev->kind) {
+        case JOB_FOUNDATION:    snprintf(buf, size, "Temel atma"); break;
+        case JOB_FLOOR:         snprintf(buf, size, "Kat %d kaba inşaatı", ev->floor+1); break;
+        case JOB_ROOF_SKELETON: snprintf(buf, size, "Çatı iskeleti"); break;
+        case JOB_APARTMENT:     snprintf(buf, size, "Kat %d Daire %d iç dizayn", ev->floor+1, ev->apartment+1); break;
+        default:                snprintf(buf, size, "Çatı katı"); break;
+        }
+        break;
+    case TRACE_STEP:          step_label(buf, size, ev->kind, ev->index); break;
+    case TRACE_MAIL_POST:     snprintf(buf, size, "Kat %d bildirimini gönder", ev->floor+1); break;
+    case TRACE_MAIL_WAIT:     snprintf(buf, size, "Kat %d bildirimini bekle", ev->floor+1); break;
+    case TRACE_RESOURCE_WAIT: snprintf(buf, size, "Bekleme: %s", resource_names[ev->kind]); break;
+    default:                  snprintf(buf, size, "?"); break;
+    }
+}
+
+// İz alanındaki olayları Chrome trace-event JSON olarak yazar ve alanı bırakır
+void trace_write(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        perror("iz dosyası açılamadı");
+        exit(EXIT_FAILURE);
+    }
+    int used = atomic_load(&trace_arena->next_chunk);
+    if (used > trace_arena->chunk_count) used = trace_arena->chunk_count;
+    unsigned long written = 0;
+    char name[160];
+
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"İnşaat (ana süreç)\"}}", (int)getpid());
+    for (int c = 0; c < used; c++) {
+        const struct TraceChunk *chunk = &trace_arena->chunks[c];
+        for (int i = 0; i < chunk->used; i++) {
+            const struct TraceEvent *ev = &chunk->events[i];
+            if (ev->phase == 'M') { // Süreç ve thread adları
+                const char *meta = ev->kind == TRACE_NAME_FLOOR || ev->kind == TRACE_NAME_FLOOR_WORKER ? "process_name" : "thread_name";
+                if (ev->kind == TRACE_NAME_MAIN) snprintf(name, sizeof(name), "Ana thread (kat fork)");
+                else if (ev->kind == TRACE_NAME_WORKER) snprintf(name, sizeof(name), "Havuz işçisi %d", ev->floor);
+                else if (ev->kind == TRACE_NAME_FLOOR) snprintf(name, sizeof(name), "Kat %d süreci", ev->floor+1);
+                else if (ev->kind == TRACE_NAME_FLOOR_WORKER) snprintf(name, sizeof(name), "Kat işçisi %d", ev->floor);
+                else {
+                    struct TraceEvent job = *ev;
+                    job.what = TRACE_JOB;
+                    job.kind = ev->index;
+                    trace_event_name(name, sizeof(name), &job);
+                }
+                fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                        meta, ev->pid, ev->tid, name);
+                written++;
+                continue;
+            }
+            if (ev->phase == 's' || ev->phase == 'f') { // Akış okları: kat bildirimi gönderme → bekleme, kaynak bırakma → devralma
+                const char *cat = ev->what == TRACE_MAIL_POST || ev->what == TRACE_MAIL_WAIT ? "kat bildirimi" : "kaynak devri";
+                fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"id\":%u,\"pid\":%d,\"tid\":%d,\"ts\":%.3f%s}",
+                        cat, cat, ev->phase, ev->id, ev->pid, ev->tid, ev->ts / 1e3,
+                        ev->phase == 'f' ? ",\"bp\":\"e\"" : "");
+                written++;
+                continue;
+            }
+            trace_event_name(name, sizeof(name), ev);
+            const char *cat = ev->what == TRACE_JOB ? "iş" : ev->what == TRACE_STEP ? "adım" : "bekleme";
+            fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f",
+                    name, cat, ev->phase, ev->pid, ev->tid, ev->ts / 1e3);
+            if (ev->phase == 'X') fprintf(out, ",\"dur\":%.3f", ev->dur / 1e3);
+            if (ev->phase == 'b' || ev->phase == 'e') fprintf(out, ",\"id\":%u", ev->id);
+            if (ev->phase != 'E' && ev->phase != 'e') {
+                fprintf(out, ",\"args\":{\"kat\":%d,\"daire\":%d}", ev->floor + 1, ev->apartment + 1);
+            }
+            fprintf(out, "}");
+            written++;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    if (fclose(out) != 0) {
+        perror("iz dosyası yazılamadı");
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned long dropped = atomic_load(&trace_arena->dropped);
+    printf("İz dosyası: %s (%lu olay, %d parça%s)\n", path, written, used,
+           dropped ? ", alan doldu: bazı olaylar atlandı" : "");
+    if (dropped) printf("Atlanan iz olayı: %lu\n", dropped);
+    munmap(trace_arena, trace_arena_size);
+    trace_arena = NULL; // Sonraki (karşılaştırma) koşuları iz yazmaz
+}
+
+#define ANALYZE_CHUNK_RECORDS (1L << 20) // Çözümleme görevi başına kayıt (32 MB)
+#define EVENT_STEP_SLOTS 16               // İş türü başına en fazla adım (özet tablosu için)
+
+// Olay günlüğünün bir bölümünün özeti; görevlerin özetleri sonunda toplanır
+struct EventRollup {
+    int64_t *floor_material;              // Kat başına malzeme, kuruş (son eleman: binaya ait kayıtlar)
+    int64_t *floor_labor;                 // Kat başına işçilik, kuruş
+    uint64_t *floor_steps;                // Kat başına biten adım
+    int64_t cat_material[CAT_COUNT];      // Kategori başına malzeme, kuruş
+    int64_t cat_labor[CAT_COUNT];         // Kategori başına işçilik, kuruş
+    uint64_t starts[JOB_KIND_COUNT][EVENT_STEP_SLOTS]; // Başlayan adım
+    uint64_t ends[JOB_KIND_COUNT][EVENT_STEP_SLOTS];   // Biten adım
+    double start_sum[JOB_KIND_COUNT][EVENT_STEP_SLOTS]; // Başlangıç zamanlarının toplamı (ns)
+    double end_sum[JOB_KIND_COUNT][EVENT_STEP_SLOTS];   // Bitiş zamanlarının toplamı (ns)
+    uint64_t first_start[JOB_KIND_COUNT]; // İş türünün ilk adım başlangıcı
+    uint64_t last_end[JOB_KIND_COUNT];    // İş türünün son adım bitişi
+    uint64_t records;                     // Geçerli kayıt
+    uint64_t empty;                       // Yazılmamış (türü 0) kayıt
+    uint64_t invalid;                     // Alanları aralık dışında olan kayıt
+};
+
+// Günlüğün bir aralığını tarayan havuz görevi
+struct AnalyzeTask {
+    struct PoolTask task;                 // Havuz görevi (ilk üye)
+    const struct EventRecord *records;    // Eşlenen kayıtlar (salt okunur)
+    long begin, end;                      // Taranacak aralık
+    int floors;                           // Kat sayısı (dosya başlığından)
+    struct EventRollup rollup;            // Aralığın özeti
+};
+
+static void rollup_init(struct EventRollup *r, int floors) {
+    memset(r, 0, sizeof(*r));
+    r->floor_material = calloc(floors + 1, sizeof(int64_t));
+    r->floor_labor = calloc(floors + 1, sizeof(int64_t));
+    r->floor_steps = calloc(floors + 1, sizeof(uint64_t));
+    if (!r->floor_material || !r->floor_labor || !r->floor_steps) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < JOB_KIND_COUNT; k++) r->first_start[k] = UINT64_MAX;
+}
+
+static void rollup_free(struct EventRollup *r) {
+    free(r->floor_material);
+    free(r->floor_labor);
+    free(r->floor_steps);
+}
+
+// Aralıktaki kayıtları tek geçişte özetler. Kayıtlar eşlemeden yerinde okunur; sıralı okuma
+// ve havuzdaki işçilere bölme, gruplu toplamların (kat, kategori, adım) dağınık yazmasından baskındır.
+static void analyze_task(struct PoolTask *task) {
+    struct AnalyzeTask *t = (struct AnalyzeTask *)task;
+    struct EventRollup *r = &t->rollup;
+    rollup_init(r, t->floors);
+    for (long i = t->begin; i < t->end; i++) {
+        const struct EventRecord *ev = &t->records[i];
+        if (ev->type == EVENT_NONE) {
+            r->empty++;
+            continue;
+        }
+        int f = ev->floor < 0 ? t->floors : ev->floor;
+        int step_record = ev->type != EVENT_COST;
+        if (ev->type > EVENT_COST || f > t->floors || ev->category >= CAT_COUNT ||
+            (step_record && (ev->kind >= JOB_KIND_COUNT || ev->step >= EVENT_STEP_SLOTS))) {
+            r->invalid++;
+            continue;
+        }
+        r->records++;
+        if (ev->type != EVENT_STEP_START) { // Bitiş ve maliyet kayıtları maliyet taşır
+            r->floor_material[f] += ev->material;
+            r->floor_labor[f] += ev->labor;
+            r->cat_material[ev->category] += ev->material;
+            r->cat_labor[ev->category] += ev->labor;
+        }
+        if (ev->type == EVENT_STEP_START) {
+            r->starts[ev->kind][ev->step]++;
+            r->start_sum[ev->kind][ev->step] += (double)ev->time;
+            if (ev->time < r->first_start[ev->kind]) r->first_start[ev->kind] = ev->time;
+        } else if (ev->type == EVENT_STEP_END) {
+            r->ends[ev->kind][ev->step]++;
+            r->end_sum[ev->kind][ev->step] += (double)ev->time;
+            if (ev->time > r->last_end[ev->kind]) r->last_end[ev->kind] = ev->time;
+            r->floor_steps[f]++;
+        }
+    }
+}
+
+// Görevin özetini toplam özete ekler
+static void rollup_merge(struct EventRollup *into, const struct EventRollup *from, int floors) {
+    for (int f = 0; f <= floors; f++) {
+        into->floor_material[f] += from->floor_material[f];
+        into->floor_labor[f] += from->floor_labor[f];
+        into->floor_steps[f] += from->floor_steps[f];
+    }
+    for (int c = 0; c < CAT_COUNT; c++) {
+        into->cat_material[c] += from->cat_material[c];
+        into->cat_labor[c] += from->cat_labor[c];
+    }
+    for (int k = 0; k < JOB_KIND_COUNT; k++) {
+        for (int i = 0; i < EVENT_STEP_SLOTS; i++) {
+            into->starts[k][i] += from->starts[k][i];
+            into->ends[k][i] += from->ends[k][i];
+            into->start_sum[k][i] += from->start_sum[k][i];
+            into->end_sum[k][i] += from->end_sum[k][i];
+        }
+        if (from->first_start[k] < into->first_start[k]) into->first_start[k] = from->first_start[k];
+        if (from->last_end[k] > into->last_end[k]) into->last_end[k] = from->last_end[k];
+    }
+    into->records += from->records;
+    into->empty += from->empty;
+    into->invalid += from->invalid;
+}
+
+// --analyze=DOSYA: olay günlüğünü eşler, iş havuzunda paralel tarar ve kat, kategori ve
+// adım özetlerini yazdırır. Maliyetler kopya başına ortalamadır (tek koşuda koşunun kendisi).
+void run_analyze(const char *path) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror("olay günlüğü açılamadı");
+        exit(EXIT_FAILURE);
+    }
+    const char *base = NULL;
+    if ((size_t)st.st_size >= EVENT_LOG_DATA) {
+        base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) base = NULL;
+    }
+    close(fd);
+    const struct EventLogHeader *h = (const struct EventLogHeader *)base;
+    if (!h || h->magic != EVENT_LOG_MAGIC || h->version != EVENT_LOG_VERSION ||
+        h->record_size != sizeof(struct EventRecord) || h->floors <= 0) {
+        fprintf(stderr, "Geçersiz olay günlüğü: %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    madvise((void *)base, st.st_size, MADV_SEQUENTIAL);
+    long count = (long)((st.st_size - EVENT_LOG_DATA) / sizeof(struct EventRecord));
+    const struct EventRecord *records = (const struct EventRecord *)(base + EVENT_LOG_DATA);
+    int floors = h->floors;
+
+    long task_count = (count + ANALYZE_CHUNK_RECORDS - 1) / ANALYZE_CHUNK_RECORDS;
+    struct AnalyzeTask *tasks = calloc(task_count > 0 ? task_count : 1, sizeof(struct AnalyzeTask));
+    if (!tasks) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    struct WorkerPool *pool = pool_create(pool_workers);
+    for (long i = 0; i < task_count; i++) {
+        long end = (i + 1) * ANALYZE_CHUNK_RECORDS;
+        tasks[i] = (struct AnalyzeTask){ { analyze_task, NULL }, records, i * ANALYZE_CHUNK_RECORDS,
+                                         end < count ? end : count, floors, { 0 } };
+        pool_submit(pool, &tasks[i].task);
+    }
+    pool_wait(pool);
+    int workers = pool->worker_count;
+    pool_destroy(pool);
+    struct EventRollup total;
+    rollup_init(&total, floors);
+    for (long i = 0; i < task_count; i++) { // Görev sırasıyla topla (tekrarlanabilir)
+        rollup_merge(&total, &tasks[i].rollup, floors);
+        rollup_free(&tasks[i].rollup);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double elapsed_ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+
+    int replicas = h->replicas > 0 ? h->replicas : 1;
+    const char *unit = h->mode == MODE_VIRTUAL ? "gün" : "sn";
+    printf(COLOR_GREEN "\n=== OLAY GÜNLÜĞÜ ÇÖZÜMLEMESİ ===\n" COLOR_RESET);
+    printf("Dosya: %s (%.1f MB, %llu kayıt, %llu boş", path, st.st_size / 1e6,
+           (unsigned long long)total.records, (unsigned long long)total.empty);
+    if (total.invalid > 0) printf(", %llu geçersiz", (unsigned long long)total.invalid);
+    printf(")\n");
+    printf("Koşu: %d kat x %d daire, tohum %llu, %s, %d kopya\n", h->floors, h->apartments,
+           (unsigned long long)h->seed, h->mode == MODE_VIRTUAL ? "sanal zaman" : "gerçek zaman", replicas);
+    printf("Tarama: %.2f ms (%.2f GB/sn, %d işçi)\n", elapsed_ms, st.st_size / 1e6 / elapsed_ms, workers);
+
+    printf(COLOR_CYAN "\n=== KATEGORİ BAŞINA MALİYET%s ===\n" COLOR_RESET, replicas > 1 ? " (kopya başına)" : "");
+    printf("Kategori                | Malzeme Maliyeti | İşçilik Maliyeti | Toplam\n");
+    printf("------------------------|------------------|------------------|------------\n");
+    int64_t grand = 0; // Kuruş; tek koşuda defterin toplamıyla aynıdır
+    for (int c = 0; c < CAT_COUNT; c++) {
+        double material = total.cat_material[c] / 100.0 / replicas, labor = total.cat_labor[c] / 100.0 / replicas;
+        grand += total.cat_material[c] + total.cat_labor[c];
+        printf("%s | %16.2f | %16.2f | %.2f TL\n", category_labels[c], material, labor,
+               (total.cat_material[c] + total.cat_labor[c]) / 100.0 / replicas);
+    }
+    printf("TOPLAM                  |                  |                  | %.2f TL\n", grand / 100.0 / replicas);
+
+    printf(COLOR_CYAN "\n=== KAT BAŞINA MALİYET%s ===\n" COLOR_RESET, replicas > 1 ? " (kopya başına)" : "");
+    printf("Kat          | Biten adım | Malzeme Maliyeti | İşçilik Maliyeti | Toplam\n");
+    printf("-------------|------------|------------------|------------------|------------\n");
+    for (int f = 0; f <= floors; f++) {
+        if (total.floor_steps[f] == 0 && total.floor_material[f] + total.floor_labor[f] == 0) continue;
+        char label[16];
+        if (f < floors) snprintf(label, sizeof(label), "Kat %d", f + 1);
+        else snprintf(label, sizeof(label), "Bina geneli");
+        double material = total.floor_material[f] / 100.0 / replicas, labor = total.floor_labor[f] / 100.0 / replicas;
+        printf("%-12s | %10llu | %16.2f | %16.2f | %.2f TL\n", label, (unsigned long long)total.floor_steps[f],
+               material, labor, (total.floor_material[f] + total.floor_labor[f]) / 100.0 / replicas);
+    }
+
+    printf(COLOR_CYAN "\n=== ADIM SÜRELERİ (%s) ===\n" COLOR_RESET, unit);
+    printf("İş                | Adım                                          |   Biten | Ort. süre | İlk başlangıç | Son bitiş\n");
+    printf("------------------|-----------------------------------------------|---------|-----------|---------------|----------\n");
+    for (int k = 0; k < JOB_KIND_COUNT; k++) {
+        for (int i = 0; i < job_programs[k].step_count && i < EVENT_STEP_SLOTS; i++) {
+            if (total.ends[k][i] == 0 && total.starts[k][i] == 0) continue;
+            char name[96];
+            step_label(name, sizeof(name), k, i);
+            print_padded(job_kind_labels[k], 17);
+            printf(" | ");
+            print_padded(name, 45);
+            printf(" | %7llu | ", (unsigned long long)total.ends[k][i]);
+            if (total.starts[k][i] == total.ends[k][i]) { // Süreler toplamı: bitişler toplamı - başlangıçlar toplamı
+                printf("%9.3f", (total.end_sum[k][i] - total.start_sum[k][i]) / total.ends[k][i] / TRACE_NS_PER_DAY);
+            } else {                                      // Çöken kat süreçlerinin yarım adımları
+                printf("%9s", "eşleşmez");
+            }
+            if (i == 0) printf(" | %13.3f | %9.3f\n", total.first_start[k] / TRACE_NS_PER_DAY, total.last_end[k] / TRACE_NS_PER_DAY);
+            else printf(" |               |\n");
+        }
+    }
+
+    rollup_free(&total);
+    free(tasks);
+    munmap((void *)base, st.st_size);
+}
+
+// ---------------------------------------------------------------------------
+// construction-top (--top ya da "construction-top" adıyla çağrılan program): koşan simülasyonun
+// ölçüm bölgesini salt okunur eşler ve verilen aralıkla ekrana çizer. Okuyucu yalnızca okur;
+// yayıncı o sırada yazıyorsa görüntüyü yeniden okur. Simülasyon henüz başlamadıysa bekler,
+// bittiğinde son görüntüyü çizip çıkar.
+// ---------------------------------------------------------------------------
+
+#define TOP_BAR_WIDTH 30  // İlerleme çubuğunun genişliği
+
+// Ölçüm bölgesine bağlanır; bölge yoksa, henüz yayınlanmadıysa ya da yayıncısı öldüyse NULL döner
+static struct MetricsSegment *metrics_attach(void) {
+    int fd = shm_open(METRICS_NAME, O_RDONLY, 0);
+    if (fd == -1) return NULL;
+    struct stat st;
+    struct MetricsSegment *segment = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(struct MetricsSegment)) { // Yayıncı boyutu ayarlamış olmalı
+        segment = mmap(NULL, sizeof(struct MetricsSegment), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (segment == MAP_FAILED) return NULL;
+    atomic_thread_fence(memory_order_acquire);
+    if (segment->magic != METRICS_MAGIC || segment->size != sizeof(struct MetricsSnapshot) || kill(segment->pid, 0) != 0) {
+        munmap(segment, sizeof(struct MetricsSegment));
+        return NULL;
+    }
+    return segment;
+}
+
+// done/total oranında dolu bir ilerleme çubuğu yazar
+static void top_bar(int64_t done, int64_t total) {
+    int fill = total > 0 ? (int)(done * TOP_BAR_WIDTH / total) : 0;
+    printf("[%.*s%*s] %5.1f%%", fill, "##############################", TOP_BAR_WIDTH - fill, "",
+           total > 0 ? 100.0 * done / total : 0.0);
+}
+
+// Görüntüyü ekrana çizer
+static void top_draw(const struct MetricsSnapshot *snap, int pid, long retries) {
+    printf("\033[H\033[2J"); // İmleci başa al ve ekranı temizle
+    printf(COLOR_CYAN "construction-top" COLOR_RESET " | PID %d | %s | %d. gün | yayın %llu (%.1f ms önce) | yeniden okuma %ld\n\n",
+           pid, snap->mode == MODE_VIRTUAL ? "sanal zaman" : "gerçek zaman", snap->day,
+           (unsigned long long)snap->publishes, (monotonic_ns() - snap->published_ns) / 1e6, retries);
+    print_padded("Kaba inşaatı biten katlar", 48);
+    top_bar(snap->floors_done, snap->floors_total);
+    printf("  %d/%d\n\n", snap->floors_done, snap->floors_total);
+
+    printf("Daire aşamaları (%lld daire)\n", (long long)snap->apartments_total);
+    for (int s = 0; s < snap->stage_count && s < METRICS_STAGES; s++) {
+        char label[64];
+        step_label(label, sizeof(label), JOB_APARTMENT, s);
+        printf("  ");
+        print_padded(label, 46);
+        top_bar(snap->stage_done[s], snap->apartments_total);
+        printf("  %lld\n", (long long)snap->stage_done[s]);
+    }
+
+    printf("\nKategori               | Maliyet (TL)\n");
+    printf("-----------------------|-----------------\n");
+    for (int c = 0; c < CAT_COUNT; c++) printf("%s | %16.2f\n", category_labels[c], snap->cost[c]);
+    printf("Toplam                 | %16.2f\n", snap->total_cost);
+
+    printf("\nKaynak              | Ekip | Çalışan | Bekleyen\n");
+    printf("--------------------|------|---------|---------\n");
+    for (int r = 0; r < RES_COUNT; r++) {
+        printf("%s | %4d | %7d | %8d\n", resource_labels[r], snap->crews[r], snap->busy[r], snap->queued[r]);
+    }
+    fflush(stdout);
+}
+
+// İzleme döngüsü: interval_ms'de bir bölgeyi okuyup çizer; koşu bitince çıkar
+void run_top(int interval_ms) {
+    struct timespec interval = { interval_ms / 1000, (long)(interval_ms % 1000) * 1000000L };
+    struct MetricsSegment *segment = NULL;
+    long retries = 0;
+    int announced = 0;
+    for (;;) {
+        if (!segment) segment = metrics_attach();
+        if (!segment) { // Simülasyon henüz başlamadı: başlamasını bekle
+            if (!announced) printf("Simülasyon bekleniyor (%s)...\n", METRICS_NAME);
+            fflush(stdout);
+            announced = 1;
+            nanosleep(&interval, NULL);
+            continue;
+        }
+        struct MetricsSnapshot snap;
+        retries += metrics_read(segment, &snap);
+        top_draw(&snap, segment->pid, retries);
+        if (snap.finished) break;
+        if (kill(segment->pid, 0) != 0) { // Yayıncı bitiş yayınlamadan öldü: yeni koşuyu bekle
+            printf("\nYayıncı süreç %d sonlandı\n", segment->pid);
+            munmap(segment, sizeof(struct MetricsSegment));
+            segment = NULL;
+            announced = 0;
+        }
+        nanosleep(&interval, NULL);
+    }
+    printf("\nİnşaat tamamlandı.\n");
+    munmap(segment, sizeof(struct MetricsSegment));
+}
+
+// Günlük kıyaslaması için üretici thread argümanları
+struct LogBenchArgs {
+    int thread;        // Üretici numarası (daire numarası olarak kullanılır)
+    long events;       // Üretilecek kayıt sayısı
+    int use_ring;      // 1: halkaya yaz, 0: doğrudan biçimlendirip yaz
+    FILE *out;         // Doğrudan yazmada kullanılan akış
+};
+
+// Kıyaslama üreticisi: daire adımlarına benzeyen kayıtlar üretir
+static void *log_bench_worker(void *arg) {
+    struct LogBenchArgs *a = arg;
+    int steps = job_programs[JOB_APARTMENT].step_count;
+    for (long i = 0; i < a->events; i++) {
+        int floor = (int)(i / (2 * steps)) % total_floors;
+        int step = (int)(i / 2) % steps;
+        if (a->use_ring) {
+            log_step(JOB_APARTMENT, floor, a->thread, step, (int)(i & 1));
+        } else { // Eski yöntem: her satır üretici thread'de biçimlendirilip yazılır
+            struct LogRecord rec = { .type = (i & 1) ? LOG_STEP_DONE : LOG_STEP_START, .kind = JOB_APARTMENT,
+                                     .index = step, .floor = floor, .apartment = a->thread, .time = -1.0 };
+            log_format(a->out, &rec);
+        }
+    }
+    return NULL;
+}
+
+// İki zaman damgası arasındaki süreyi saniye olarak döndürür
+static double elapsed_sec(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Günlük halkası kıyaslaması: doğrudan printf ile halka üzerinden yazmanın olay/sn karşılaştırması.
+// Çıktı /dev/null'a gider; doğrudan yazma terminal gibi satır tamponlu, boşaltıcı tam tamponludur.
+void run_log_benchmark(long events_per_thread) {
+    const int threads = apartments_per_floor < 64 ? apartments_per_floor : 64; // Daire başına bir üretici (en fazla 64)
+    long total = events_per_thread * threads;
+    FILE *sink = fopen("/dev/null", "w");
+    if (!sink) {
+        perror("fopen /dev/null failed");
+        exit(EXIT_FAILURE);
+    }
+    pthread_t tids[64];
+    struct LogBenchArgs args[64];
+    struct timespec t0, t1, t2;
+
+    printf("Günlük kıyaslaması: %d üretici thread x %ld olay\n", threads, events_per_thread);
+
+    // 1) Halkasız: her thread satırı kendisi biçimlendirip stdio kilidiyle yazar
+    setvbuf(sink, NULL, _IOLBF, 0);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < threads; i++) {
+        args[i] = (struct LogBenchArgs){ i, events_per_thread, 0, sink };
+        pthread_create(&tids[i], NULL, log_bench_worker, &args[i]);
+    }
+    for (int i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+    fflush(sink);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("  halkasız (doğrudan printf) : %12.0f olay/sn\n", total / elapsed_sec(&t0, &t1));
+
+    // 2) Halka: üreticiler ikili kayıt yazar, boşaltıcı biçimlendirir
+    fclose(sink);
+    sink = fopen("/dev/null", "w");
+    log_init(sink);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < threads; i++) {
+        args[i] = (struct LogBenchArgs){ i, events_per_thread, 1, NULL };
+        pthread_create(&tids[i], NULL, log_bench_worker, &args[i]);
+    }
+    for (int i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    log_shutdown(); // Halkada kalan tüm kayıtları yaz
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    printf("  halka (üretici tarafı)     : %12.0f olay/sn\n", total / elapsed_sec(&t0, &t1));
+    printf("  halka (uçtan uca)          : %12.0f olay/sn (halka dolu beklemesi: %lu)\n",
+           total / elapsed_sec(&t0, &t2), (unsigned long)atomic_load(&shared_data->log.full_waits));
+
+    // 3) Sessiz seviye: görev satırları halkaya hiç yazılmaz
+    enum LogLevel saved = log_level;
+    log_level = LOG_LEVEL_QUIET;
+    log_init(sink);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < threads; i++) {
+        args[i] = (struct LogBenchArgs){ i, events_per_thread, 1, NULL };
+        pthread_create(&tids[i], NULL, log_bench_worker, &args[i]);
+    }
+    for (int i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+    log_shutdown();
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("  halka, sessiz seviye       : %12.0f olay/sn\n", total / elapsed_sec(&t0, &t1));
+    log_level = saved;
+    fclose(sink);
+}
+
+// ---------------------------------------------------------------------------
+// Kıyaslama takımı (--bench): eşzamanlılık temel taşlarının ve aşamaların maliyetini ölçer.
+// Her ölçüm stdout'a tek satırlık bir JSON nesnesi olarak yazılır; sürümler arası gerilemeler
+// satırlar karşılaştırılarak yakalanır. Kıyaslama sırasında günlük kapalıdır.
+// ---------------------------------------------------------------------------
+
+enum BenchSuite {
+    BENCH_ADD_COST,       // add_cost verimi: 1..N yarışan thread ve süreç
+    BENCH_FLOOR_HANDOFF,  // Kat sürecinden ana sürece bildirim gecikmesi
+    BENCH_DISPATCH,       // Kat başına fork+waitpid, thread ve havuz gönderimi
+    BENCH_ELEVATOR,       // Asansör semaforu al/bırak tur süresi
+    BENCH_E2E,            // Gecikmeler sıfırken uçtan uca bina/sn
+    BENCH_ROLLUP,         // Kuruş matrisinin üç eksendeki toplamı
+    BENCH_RECOST,         // Defterdeki miktarlardan yeniden fiyatlama
+    BENCH_COUNT
+};
+
+static const char *bench_names[BENCH_COUNT] = {
+    "add_cost", "floor_handoff", "dispatch", "elevator", "e2e", "rollup", "recost"
+};
+
+// Tek ölçüm satırı: toplam süre ns, işlem sayısı ops
+static void bench_report(const char *bench, const char *variant, int workers, long ops, uint64_t ns) {
+    printf("{\"bench\":\"%s\",\"variant\":\"%s\",\"workers\":%d,\"ops\":%ld,\"ns_per_op\":%.1f,\"ops_per_sec\":%.0f}\n",
+           bench, variant, workers, ops, (double)ns / ops, ops / (ns / 1e9));
+    fflush(stdout); // Çocuk süreçler tamponu kopyalamasın
+}
+
+// add_cost üreticisi: kendi dilimine n maliyet yazar
+static void *bench_add_cost_worker(void *arg) {
+    long n = *(const long *)arg;
+    for (long i = 0; i < n; i++) add_cost(1.0, 0.4, CAT_FLOOR);
+    return NULL;
+}
+
+// Boş thread gövdesi
+static void *bench_noop_thread(void *arg) {
+    return arg;
+}
+
+// Boş havuz görevi
+static void bench_noop_task(struct PoolTask *task) {
+    (void)task;
+}
+
+// Asansör üreticisi: n kez asansörü alıp bırakır
+static void *bench_elevator_worker(void *arg) {
+    long n = *(const long *)arg;
+    for (long i = 0; i < n; i++) {
+        resource_acquire(RES_ELEVATOR);
+        resource_release(RES_ELEVATOR);
+    }
+    return NULL;
+}
+
+// n thread'i aynı gövdeyle başlatıp bitmelerini bekler; geçen süreyi (ns) döndürür
+static uint64_t bench_threads(int n, void *(*body)(void *), long per_thread) {
+    pthread_t tids[64];
+    uint64_t start = monotonic_ns();
+    for (int i = 0; i < n; i++) pthread_create(&tids[i], NULL, body, &per_thread);
+    for (int i = 0; i < n; i++) pthread_join(tids[i], NULL);
+    return monotonic_ns() - start;
+}
+
+// 1, 2, 4, ... yarışan thread ve süreçle add_cost verimi
+static void bench_add_cost(int max_workers) {
+    const long per_worker = 200000;
+    for (int n = 1; n <= max_workers; n *= 2) {
+        bench_report("add_cost", "threads", n, per_worker * n, bench_threads(n, bench_add_cost_worker, per_worker));
+
+        uint64_t start = monotonic_ns();
+        for (int i = 0; i < n; i++) {
+            pid_t pid = fork();
+            if (pid == 0) { // Her süreç kendi dilimini alır
+                bench_add_cost_worker((void *)&per_worker);
+                cost_shard_release();
+                _exit(0);
+            } else if (pid < 0) {
+                perror("fork hatası");
+                exit(EXIT_FAILURE);
+            }
+        }
+        while (wait(NULL) > 0) { }
+        bench_report("add_cost", "processes", n, per_worker * n, monotonic_ns() - start);
+    }
+}
+
+// Kat bildirimi gecikmesi: iki süreç paylaşılan eşlemedeki iki posta kutusu üzerinden mesajı
+// karşılıklı gönderir (ping-pong); tek yön gecikmesi tur süresinin yarısıdır. Önce varsayılan
+// dönme+futex yolu, sonra dönmeden doğrudan futex'e düşen yol ölçülür.
+static void bench_floor_handoff(void) {
+    const long rounds = 20000;
+    struct Mailbox *mail = mmap(NULL, 2 * sizeof(struct Mailbox), PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mail == MAP_FAILED) {
+        perror("mmap failed");
+        exit(EXIT_FAILURE);
+    }
+    int saved_spins = mailbox_spins;
+    for (int futex_only = 0; futex_only < 2; futex_only++) {
+        mailbox_spins = futex_only ? 0 : -1;
+        mailbox_reset(&mail[0]);
+        mailbox_reset(&mail[1]);
+        uint64_t start = monotonic_ns();
+        pid_t pid = fork();
+        if (pid == 0) { // Kat süreci tarafı: mesajı alır, aynen geri gönderir
+            struct FloorMessage msg;
+            for (long k = 0; k < rounds; k++) {
+                mailbox_wait(&mail[0], (uint32_t)k, &msg, -1);
+                mailbox_post(&mail[1], &msg);
+            }
+            _exit(0);
+        } else if (pid < 0) {
+            perror("fork hatası");
+            exit(EXIT_FAILURE);
+        }
+        for (long k = 0; k < rounds; k++) {
+            struct FloorMessage msg = { .floor = (int32_t)(k % total_floors) };
+            mailbox_post(&mail[0], &msg);
+            mailbox_wait(&mail[1], (uint32_t)k, &msg, -1);
+        }
+        uint64_t elapsed = monotonic_ns() - start;
+        waitpid(pid, NULL, 0);
+        bench_report("floor_handoff", futex_only ? "mailbox_futex" : "mailbox", 2, 2 * rounds, elapsed);
+    }
+    mailbox_spins = saved_spins;
+    munmap(mail, 2 * sizeof(struct Mailbox));
+}
+
+// Bir işi başlatmanın maliyeti: kat başına fork+waitpid, thread oluşturma+join, havuz gönderimi
+static void bench_dispatch(int workers) {
+    const long forks = 500, threads = 2000, tasks = 200000, round_trips = 20000;
+    uint64_t start = monotonic_ns();
+    for (long i = 0; i < forks; i++) {
+        pid_t pid = fork();
+        if (pid == 0) _exit(0);
+        if (pid < 0) {
+            perror("fork hatası");
+            exit(EXIT_FAILURE);
+        }
+        waitpid(pid, NULL, 0);
+    }
+    bench_report("dispatch", "fork_waitpid", 1, forks, monotonic_ns() - start);
+
+    start = monotonic_ns();
+    for (long i = 0; i < threads; i++) {
+        pthread_t tid;
+        pthread_create(&tid, NULL, bench_noop_thread, NULL);
+        pthread_join(tid, NULL);
+    }
+    bench_report("dispatch", "pthread_create_join", 1, threads, monotonic_ns() - start);
+
+    struct WorkerPool *pool = pool_create(workers);
+    struct PoolTask *noop = calloc(tasks, sizeof(struct PoolTask));
+    if (!noop) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    start = monotonic_ns();
+    for (long i = 0; i < round_trips; i++) { // Tek görev: gönder ve bitmesini bekle
+        noop[0].run = bench_noop_task;
+        pool_submit(pool, &noop[0]);
+        pool_wait(pool);
+    }
+    bench_report("dispatch", "pool_round_trip", pool->worker_count, round_trips, monotonic_ns() - start);
+    start = monotonic_ns();
+    for (long i = 0; i < tasks; i++) { // Toplu gönderim: havuzun verimi
+        noop[i].run = bench_noop_task;
+        pool_submit(pool, &noop[i]);
+    }
+    pool_wait(pool);
+    bench_report("dispatch", "pool_submit", pool->worker_count, tasks, monotonic_ns() - start);
+    pool_destroy(pool);
+    free(noop);
+}
+
+// Asansör semaforu al/bırak turu: yarışmasız ve yarışan thread'lerle (ölçüm sayaçları dahil)
+static void bench_elevator(int max_workers) {
+    const long per_worker = 200000;
+    for (int n = 1; n <= max_workers; n *= 2) {
+        bench_report("elevator", n == 1 ? "uncontended" : "contended", n, per_worker * n,
+                     bench_threads(n, bench_elevator_worker, per_worker));
+    }
+}
+
+// Gecikmeler sıfırken uçtan uca bina/sn: gerçek modda kat başına fork ve kalıcı kat işçileriyle
+// (--floor-procs, varsayılan 2), ayrıca sanal modda
+static void bench_e2e(int workers) {
+    const long wall_buildings = 20, virtual_buildings = 1000;
+    double saved_scale = delay_scale;
+    delay_scale = 0.0;
+    struct TaskGraph graph;
+    graph_build(&graph, schedule_mode);
+
+    int proc_count = floor_procs > 0 ? floor_procs : 2;
+    struct FloorProcs *procs = floor_procs_create(proc_count); // Havuz thread'lerinden önce fork et
+    struct WorkerPool *pool = pool_create(workers);
+    uint64_t start = monotonic_ns();
+    for (long b = 0; b < wall_buildings; b++) run_wallclock_simulation(&graph, pool, NULL);
+    bench_report("e2e", "wall", pool->worker_count, wall_buildings, monotonic_ns() - start);
+    start = monotonic_ns();
+    for (long b = 0; b < wall_buildings; b++) run_wallclock_simulation(&graph, pool, procs); // İşçiler binalar arasında yaşar
+    bench_report("e2e", "wall_prefork", proc_count, wall_buildings, monotonic_ns() - start);
+    pool_destroy(pool);
+    floor_procs_destroy(procs);
+
+    run_mode = MODE_VIRTUAL;
+    start = monotonic_ns();
+    for (long b = 0; b < virtual_buildings; b++) {
+        random_stream((uint64_t)b);
+        run_virtual_simulation(&graph, crew_counts, 0, NULL);
+    }
+    bench_report("e2e", "virtual", 1, virtual_buildings, monotonic_ns() - start);
+    run_mode = MODE_WALLCLOCK;
+    graph_free(&graph);
+    delay_scale = saved_scale;
+}
+
+static void bench_rollup(void); // Matrisin tanımlarının yanında
+
+// Yeniden fiyatlama: koşunun fiyat tablosuyla defterin miktarlarından toplam (--what-if satırı başına)
+static void bench_recost(void) {
+    const long rounds = 200000;
+    struct CostTotals totals;
+    uint64_t start = monotonic_ns();
+    for (long i = 0; i < rounds; i++) recost(&prices, &totals);
+    bench_report("recost", "ledger", 1, rounds, monotonic_ns() - start);
+}
+
+// Seçilen kıyaslamaları çalıştırır; ilk satır ölçümlerin koşullarını (bina boyutu, işlemci sayısı) verir
+void run_bench(unsigned suites) {
+    enum LogLevel saved = log_level;
+    log_level = LOG_LEVEL_QUIET;
+    int nproc = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int max_workers = 2 * nproc > 8 ? 2 * nproc : 8; // Yarışma için işlemci sayısının iki katına kadar
+    if (max_workers > 64) max_workers = 64;
+    int workers = pool_workers > 0 ? pool_workers : nproc; // Gerçek moddaki havuzla aynı varsayılan
+
+    printf("{\"bench\":\"meta\",\"floors\":%d,\"apartments\":%d,\"nproc\":%d,\"max_workers\":%d,\"pool_workers\":%d,"
+           "\"seed\":%llu}\n", total_floors, apartments_per_floor, nproc, max_workers, workers,
+           (unsigned long long)run_seed);
+    fflush(stdout);
+    if (suites & (1u << BENCH_ADD_COST)) bench_add_cost(max_workers);
+    if (suites & (1u << BENCH_FLOOR_HANDOFF)) bench_floor_handoff();
+    if (suites & (1u << BENCH_DISPATCH)) bench_dispatch(workers);
+    if (suites & (1u << BENCH_ELEVATOR)) bench_elevator(max_workers);
+    if (suites & (1u << BENCH_E2E)) bench_e2e(workers);
+    if (suites & (1u << BENCH_ROLLUP)) bench_rollup();
+    if (suites & (1u << BENCH_RECOST)) bench_recost();
+    log_level = saved;
+}
+
+// "add_cost,e2e" gibi virgüllü listeyi kıyaslama bit maskesine çevirir ("all": hepsi)
+static unsigned parse_bench_suites(const char *list) {
+    if (!list || strcmp(list, "all") == 0) return (1u << BENCH_COUNT) - 1;
+    unsigned mask = 0;
+    const char *p = list;
+    while (*p) {
+        size_t len = strcspn(p, ",");
+        int found = -1;
+        for (int b = 0; b < BENCH_COUNT; b++) {
+            if (strlen(bench_names[b]) == len && strncmp(p, bench_names[b], len) == 0) found = b;
+        }
+        if (found < 0) {
+            fprintf(stderr, "Bilinmeyen kıyaslama: %.*s (add_cost, floor_handoff, dispatch, elevator, e2e, rollup, recost, all)\n", (int)len, p);
+            exit(EXIT_FAILURE);
+        }
+        mask |= 1u << found;
+        p += len + (p[len] == ',');
+    }
+    return mask;
+}
+
+// Ekip sayısı ve ekip-gün ücreti anahtarları (kaynak sırasıyla)
+static const char *crew_keys[RES_COUNT] = { "electric_crews", "plumbing_crews", "paint_crews", "elevators" };
+static const char *crew_cost_keys[RES_COUNT] = {
+    "electric_day_cost", "plumbing_day_cost", "paint_day_cost", "elevator_day_cost"
+};
+
+// Bina boyutu ya da ekip ayarını uygular (komut satırı ve yapılandırma dosyası ortak kullanır); bilinmeyen anahtarda 0 döner
+int set_config_option(const char *key, long value) {
+    for (int r = 0; r < RES_COUNT; r++) {
+        if (strcmp(key, crew_keys[r]) == 0) {
+            if (value <= 0 || value > MAX_CREWS) {
+                fprintf(stderr, "Geçersiz %s değeri: %ld (1..%d)\n", key, value, MAX_CREWS);
+                exit(EXIT_FAILURE);
+            }
+            crew_counts[r] = (int)value;
+            return 1;
+        }
+        if (strcmp(key, crew_cost_keys[r]) == 0) {
+            if (value < 0) {
+                fprintf(stderr, "Geçersiz %s değeri: %ld\n", key, value);
+                exit(EXIT_FAILURE);
+            }
+            crew_day_costs[r] = value;
+            return 1;
+        }
+    }
+    int *target;
+    if (strcmp(key, "floors") == 0) target = &total_floors;
+    else if (strcmp(key, "apartments") == 0) target = &apartments_per_floor;
+    else if (strcmp(key, "days") == 0) target = &total_days;
+    else return 0;
+    if (value <= 0 || value > MAX_UNITS) {
+        fprintf(stderr, "Geçersiz %s değeri: %ld (1..%ld)\n", key, value, MAX_UNITS);
+        exit(EXIT_FAILURE);
+    }
+    *target = (int)value;
+    return 1;
+}
+
+// Yapılandırma dosyasını okur: her satır "anahtar = değer", '#' ile başlayan satırlar yorumdur
+void load_config(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror("yapılandırma dosyası açılamadı");
+        exit(EXIT_FAILURE);
+    }
+    char line[256];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), file)) {
+        line_no++;
+        char key[64];
+        long value;
+        char *p = line + strspn(line, " \t");
+        if (*p == '#' || *p == '\n' || *p == '\0') continue; // Yorum ya da boş satır
+        if (sscanf(p, "%63[a-z_] = %ld", key, &value) != 2) {
+            fprintf(stderr, "%s:%d: geçersiz satır\n", path, line_no);
+            exit(EXIT_FAILURE);
+        }
+        if (!set_config_option(key, value)) {
+            fprintf(stderr, "%s:%d: bilinmeyen anahtar: %s\n", path, line_no, key);
+            exit(EXIT_FAILURE);
+        }
+    }
+    fclose(file);
+}
+
+// Fiyat dosyasını okur: her satır "anahtar = değer"; anahtarlar adımların fiyat anahtarları,
+// labor_ratio (tüm kategoriler), <kategori>_labor_ratio ve ekip-gün ücreti anahtarlarıdır
+void load_prices(const char *path, struct PriceTable *table) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror("fiyat dosyası açılamadı");
+        exit(EXIT_FAILURE);
+    }
+    char line[256];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), file)) {
+        line_no++;
+        char key[64];
+        double value;
+        char *p = line + strspn(line, " \t");
+        if (*p == '#' || *p == '\n' || *p == '\0') continue; // Yorum ya da boş satır
+        if (sscanf(p, "%63[a-z_] = %lf", key, &value) != 2 || value < 0.0) {
+            fprintf(stderr, "%s:%d: geçersiz satır\n", path, line_no);
+            exit(EXIT_FAILURE);
+        }
+        int found = 0;
+        for (int k = 0; k < JOB_KIND_COUNT && !found; k++) {
+            for (int i = 0; i < job_programs[k].step_count && !found; i++) {
+                const char *price_key = job_programs[k].steps[i].price_key;
+                if (price_key && strcmp(key, price_key) == 0) {
+                    table->material[price_item(k, i)] = value;
+                    found = 1;
+                }
+            }
+        }
+        for (int c = 0; c < CAT_COUNT && !found; c++) {
+            char ratio_key[64];
+            snprintf(ratio_key, sizeof(ratio_key), "%s_labor_ratio", category_names[c]);
+            if (strcmp(key, ratio_key) == 0) {
+                table->labor_ratio[c] = value;
+                found = 1;
+            }
+        }
+        if (!found && strcmp(key, "labor_ratio") == 0) {
+            for (int c = 0; c < CAT_COUNT; c++) table->labor_ratio[c] = value;
+            found = 1;
+        }
+        for (int r = 0; r < RES_COUNT && !found; r++) {
+            if (strcmp(key, crew_cost_keys[r]) == 0) {
+                table->crew_day[r] = value;
+                found = 1;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "%s:%d: bilinmeyen fiyat anahtarı: %s\n", path, line_no, key);
+            exit(EXIT_FAILURE);
+        }
+    }
+    fclose(file);
+}
+
+// "E,P,B,A" listesini kaynak sırasıyla (elektrik, sıhhi tesisat, boya, asansör) anahtarlara uygular
+static void set_resource_list(const char *const keys[], const char *list) {
+    const char *p = list;
+    for (int r = 0; r < RES_COUNT; r++) {
+        char *end;
+        long value = strtol(p, &end, 10);
+        if (end == p || *end != (r < RES_COUNT - 1 ? ',' : '\0')) {
+            fprintf(stderr, "Geçersiz liste: %s (elektrik,sıhhi tesisat,boya,asansör sırasıyla 4 değer)\n", list);
+            exit(EXIT_FAILURE);
+        }
+        set_config_option(keys[r], value);
+        p = end + 1;
+    }
+}
+
+// Kullanım bilgisini yazdıran fonksiyon
+void print_usage(const char *prog) {
+    printf("Kullanım: %s [--floors=N] [--apartments=N] [--days=N] [--config=DOSYA] [--mode=wall|virtual] [--schedule=pipeline|serial] [--workers=N] [--log-level=quiet|phase|task] [-q] [--bench-log[=N]] [--batch=N] [--seed=S] [--trace=DOSYA] [--slack=DOSYA] [--crews=E,P,B,A] [--crew-costs=E,P,B,A] [--tune[=N]] [--delay-scale=X] [--floor-procs=N] [--crash-floor=N] [--checkpoint=DOSYA] [--checkpoint-every=N] [--resume=DOSYA] [--halt-at=GÜN] [--event-log=DOSYA] [--analyze=DOSYA] [--sites=N] [--regions=N] [--travel-days=X] [--prices=DOSYA] [--what-if[=DOSYA]] [--top[=MS]] [--deliveries=single|batch] [--elevator-capacity=N] [--delivery-hold=GÜN] [--bench[=LİSTE]]\n", prog);
+    printf("  --floors=N       Kat sayısı (varsayılan %d)\n", DEFAULT_FLOORS);
+    printf("  --apartments=N   Kattaki daire sayısı (varsayılan %d); toplam daire en fazla %ld\n", DEFAULT_APARTMENTS_PER_FLOOR, MAX_UNITS);
+    printf("  --days=N         Planlanan gün sayısı (varsayılan %d)\n", DEFAULT_TOTAL_DAYS);
+    printf("  --config=DOSYA   \"anahtar = N\" satırlarından oluşan dosya (sonra gelen seçenek geçerli); anahtarlar: floors,\n");
+    printf("                   apartments, days, electric_crews, plumbing_crews, paint_crews, elevators, *_day_cost\n");
+    printf("  --crews=E,P,B,A  Elektrik, sıhhi tesisat, boya ekibi ve asansör sayısı (varsayılan 1,1,1,1; en fazla %d)\n", MAX_CREWS);
+    printf("  --crew-costs=... Aynı sırayla ekip-gün ücreti TL (varsayılan 2500,2500,2000,1500)\n");
+    printf("  --tune[=N]       Ekip eniyilemesi: kaynak başına 1..N ekip (varsayılan 4) bileşimlerini sanal zamanda\n");
+    printf("                   koşturup bitiş süresi/toplam maliyet Pareto sınırını yazdırır (--batch: yerleşim başına kopya, varsayılan 8)\n");
+    printf("  --mode=wall      Gerçek zamanlı mod: gecikmeler gerçekten beklenir (varsayılan, demo için)\n");
+    printf("  --mode=virtual   Sanal zamanlı mod: ayrık olay zamanlayıcısı, bina milisaniyeler içinde biter\n");
+    printf("  --schedule=S     pipeline: kabası biten katın iç dizaynı hemen başlar (varsayılan)\n");
+    printf("                   serial: eski sıra (tüm katlar, sonra kat kat iç dizayn, sonra çatı)\n");
+    printf("  --workers=N      Daire iş havuzundaki işçi thread sayısı (varsayılan: işlemci sayısı)\n");
+    printf("  --log-level=L    quiet: yalnızca özet, phase: aşama başlıkları, task: her adım (varsayılan)\n");
+    printf("  -q, --quiet      --log-level=quiet ile aynı\n");
+    printf("  --batch=N        Monte Carlo: N bağımsız kopyayı sanal zamanda paralel koşturup p50/p90/p99 yazdırır\n");
+    printf("  --seed=S         Ana rastgele tohum (varsayılan: saat); aynı tohumla sanal sonuçlar aynıdır\n");
+    printf("  --trace=DOSYA    İş, adım, kat bildirimi ve kaynak beklemelerini Chrome trace-event JSON olarak yazar\n");
+    printf("                   (chrome://tracing ya da ui.perfetto.dev ile açılır)\n");
+    printf("  --slack=DOSYA    Kritik yol raporundaki iş başına başlangıç, bitiş, bolluk ve beklemeleri CSV olarak yazar\n");
+    printf("  --delay-scale=X  Gerçek moddaki gecikmelerin çarpanı (varsayılan 1; 0.01 yüz kat hızlı, 0 beklemesiz)\n");
+    printf("  --floor-procs=N  Katları kat başına fork yerine bir kez başlatılan N kalıcı işçi sürecine dağıtır (1..%d)\n", MAX_FLOOR_PROCS);
+    printf("  --crash-floor=N  Hata enjeksiyonu: N. katın süreci ilk denemede bildirmeden ölür, kat yeniden kuyruğa alınır\n");
+    printf("  --checkpoint=DOSYA Sanal koşunun durumunu N olayda bir DOSYA'ya yazar (kontrol noktası)\n");
+    printf("  --checkpoint-every=N Kontrol noktaları arası olay sayısı (varsayılan 1000000)\n");
+    printf("  --resume=DOSYA   Sanal koşuyu kontrol noktasından sürdürür (yapılandırma dosyadan alınır)\n");
+    printf("  --halt-at=GÜN    Çökme benzetimi: sanal saat GÜN'e gelince süreç kendini öldürür\n");
+    printf("  --event-log=DOSYA Her adım başlangıcını/bitişini ve maliyet kaydını ikili olay günlüğüne yazar\n");
+    printf("  --analyze=DOSYA  Olay günlüğünden kat, kategori ve adım süresi özetlerini çıkarır\n");
+    printf("  --sites=N        Portföy modu: N şantiyeyi sanal zamanda paylaşılan ekiplerle simüle eder\n");
+    printf("  --regions=N      Portföyü kendi ekip havuzu olan N bölgeye böler (varsayılan 1: küresel havuz)\n");
+    printf("  --travel-days=X  Ekibin şantiye değiştirirken yolda geçirdiği gün (varsayılan 0.5)\n");
+    printf("  --prices=DOSYA   Birim fiyatları, işçilik oranlarını ve ekip ücretlerini \"anahtar = değer\" dosyasından okur\n");
+    printf("  --what-if[=DOSYA] Koşu sonunda fiyat değişikliklerinin maliyete etkisini koşuyu tekrarlamadan hesaplar\n");
+    printf("                   (her --what-if=DOSYA ayrı bir satır; en fazla 8 dosya)\n");
+    printf("  --deliveries=D   single: her sefer tek daireye gider, merdiven kullanılmaz (varsayılan)\n");
+    printf("                   batch: malzeme istekleri kuyrukta toplanır, asansör seferi kat ve kapasiteye göre\n");
+    printf("                   birden çok daireye uğrar, kuyruk uzunsa merdiven kullanılır\n");
+    printf("  --elevator-capacity=N Bir asansör seferinde taşınan daire malzemesi (varsayılan %d, en fazla %d)\n",
+           DEFAULT_ELEVATOR_CAPACITY, MAX_ELEVATOR_CAPACITY);
+    printf("  --delivery-hold=GÜN Kabin dolmadıysa boş asansörün en eski isteği bekletebileceği süre\n");
+    printf("                   (yalnızca batch; varsayılan %.2f: asansör boşa çıkınca hemen kalkar)\n", DEFAULT_DELIVERY_HOLD);
+    printf("  --top[=MS]       Simülasyon yerine izleyici: koşan simülasyonun canlı ölçümlerini MS'de bir (varsayılan 100)\n");
+    printf("                   çizer; program construction-top adıyla çağrılınca da izleyici olarak çalışır\n");
+    printf("  --bench[=LİSTE]  Kıyaslama takımı, her ölçüm bir JSON satırı: add_cost, floor_handoff, dispatch,\n");
+    printf("                   elevator, e2e, rollup, recost ya da all (varsayılan)\n");
+    printf("  --bench-log[=N]  Günlük halkası kıyaslaması (thread başına N olay, varsayılan 200000)\n");
+}
+
+// Komut satırı seçeneklerini ayrıştıran fonksiyon
+void parse_options(int argc, char *argv[]) {
+    static const struct option long_options[] = {
+        { "mode",      required_argument, NULL, 'm' },
+        { "log-level", required_argument, NULL, 'l' },
+        { "quiet",     no_argument,       NULL, 'q' },
+        { "bench-log", optional_argument, NULL, 'B' },
+        { "workers",   required_argument, NULL, 'w' },
+        { "schedule",  required_argument, NULL, 's' },
+        { "floors",    required_argument, NULL, 'F' },
+        { "apartments", required_argument, NULL, 'A' },
+        { "days",      required_argument, NULL, 'D' },
+        { "config",    required_argument, NULL, 'C' },
+        { "batch",     required_argument, NULL, 'N' },
+        { "seed",      required_argument, NULL, 'S' },
+        { "trace",     required_argument, NULL, 'T' },
+        { "slack",     required_argument, NULL, 'M' },
+        { "crews",     required_argument, NULL, 'R' },
+        { "crew-costs", required_argument, NULL, 'K' },
+        { "tune",      optional_argument, NULL, 'U' },
+        { "bench",     optional_argument, NULL, 'b' },
+        { "delay-scale", required_argument, NULL, 'Z' },
+        { "floor-procs", required_argument, NULL, 'P' },
+        { "crash-floor", required_argument, NULL, 'X' },
+        { "checkpoint", required_argument, NULL, 'c' },
+        { "checkpoint-every", required_argument, NULL, 'E' },
+        { "resume",    required_argument, NULL, 'r' },
+        { "halt-at",   required_argument, NULL, 'H' },
+        { "event-log", required_argument, NULL, 'L' },
+        { "analyze",   required_argument, NULL, 'a' },
+        { "sites",     required_argument, NULL, 'I' },
+        { "regions",   required_argument, NULL, 'G' },
+        { "travel-days", required_argument, NULL, 'V' },
+        { "prices",    required_argument, NULL, 'Q' },
+        { "what-if",   optional_argument, NULL, 'W' },
+        { "top",       optional_argument, NULL, 'O' },
+        { "deliveries", required_argument, NULL, 'Y' },
+        { "elevator-capacity", required_argument, NULL, 'J' },
+        { "delivery-hold", required_argument, NULL, 'd' },
+        { "help",      no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "m:qh", long_options, NULL)) != -1) {
+        switch (opt) {
+        case 'm':
+            if (strcmp(optarg, "virtual") == 0) run_mode = MODE_VIRTUAL;
+            else if (strcmp(optarg, "wall") == 0) run_mode = MODE_WALLCLOCK;
+            else {
+                fprintf(stderr, "Bilinmeyen mod: %s\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'l':
+            if (strcmp(optarg, "quiet") == 0) log_level = LOG_LEVEL_QUIET;
+            else if (strcmp(optarg, "phase") == 0) log_level = LOG_LEVEL_PHASE;
+            else if (strcmp(optarg, "task") == 0) log_level = LOG_LEVEL_TASK;
+            else {
+                fprintf(stderr, "Bilinmeyen günlük seviyesi: %s\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'q':
+            log_level = LOG_LEVEL_QUIET;
+            break;
+        case 's':
+            if (strcmp(optarg, "pipeline") == 0) schedule_mode = SCHEDULE_PIPELINE;
+            else if (strcmp(optarg, "serial") == 0) schedule_mode = SCHEDULE_SERIAL;
+            else {
+                fprintf(stderr, "Bilinmeyen zamanlama: %s\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'w':
+            pool_workers = atoi(optarg);
+            if (pool_workers <= 0) {
+                fprintf(stderr, "Geçersiz işçi sayısı: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'F':
+            set_config_option("floors", atol(optarg));
+            break;
+        case 'A':
+            set_config_option("apartments", atol(optarg));
+            break;
+        case 'D':
+            set_config_option("days", atol(optarg));
+            break;
+        case 'C':
+            load_config(optarg);
+            break;
+        case 'N':
+            batch_replicas = atol(optarg);
+            if (batch_replicas <= 0) {
+                fprintf(stderr, "Geçersiz kopya sayısı: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'S':
+            run_seed = strtoull(optarg, NULL, 0);
+            seed_given = 1;
+            break;
+        case 'T':
+            trace_path = optarg;
+            break;
+        case 'M':
+            slack_path = optarg;
+            break;
+        case 'R':
+            set_resource_list(crew_keys, optarg);
+            break;
+        case 'K':
+            set_resource_list(crew_cost_keys, optarg);
+            break;
+        case 'b':
+            bench_suites = parse_bench_suites(optarg);
+            break;
+        case 'Z':
+            delay_scale = atof(optarg);
+            if (delay_scale < 0.0) {
+                fprintf(stderr, "Geçersiz gecikme çarpanı: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'P':
+            floor_procs = atoi(optarg);
+            if (floor_procs <= 0 || floor_procs > MAX_FLOOR_PROCS) {
+                fprintf(stderr, "Geçersiz kat işçisi sayısı: %s (1..%d)\n", optarg, MAX_FLOOR_PROCS);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'X':
+            crash_floor = atoi(optarg);
+            if (crash_floor <= 0) {
+                fprintf(stderr, "Geçersiz kat: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'c':
+            checkpoint_path = optarg;
+            break;
+        case 'E':
+            checkpoint_every = atol(optarg);
+            if (checkpoint_every <= 0) {
+                fprintf(stderr, "Geçersiz olay sayısı: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'r':
+            resume_path = optarg;
+            break;
+        case 'L':
+            event_log_path = optarg;
+            break;
+        case 'a':
+            analyze_path = optarg;
+            break;
+        case 'I':
+            portfolio_sites = atoi(optarg);
+            if (portfolio_sites <= 0) {
+                fprintf(stderr, "Geçersiz şantiye sayısı: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'G':
+            portfolio_regions = atoi(optarg);
+            if (portfolio_regions <= 0) {
+                fprintf(stderr, "Geçersiz bölge sayısı: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'Y':
+            if (strcmp(optarg, "batch") == 0) delivery_mode = DELIVERY_BATCH;
+            else if (strcmp(optarg, "single") == 0) delivery_mode = DELIVERY_SINGLE;
+            else {
+                fprintf(stderr, "Bilinmeyen taşıma politikası: %s\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'J':
+            elevator_capacity = atoi(optarg);
+            if (elevator_capacity <= 0 || elevator_capacity > MAX_ELEVATOR_CAPACITY) {
+                fprintf(stderr, "Geçersiz asansör kapasitesi: %s (1..%d)\n", optarg, MAX_ELEVATOR_CAPACITY);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'd':
+            delivery_hold = atof(optarg);
+            if (delivery_hold < 0.0) {
+                fprintf(stderr, "Geçersiz bekletme süresi: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'O':
+            top_interval_ms = optarg ? atoi(optarg) : 100;
+            if (top_interval_ms <= 0 || top_interval_ms > 60000) {
+                fprintf(stderr, "Geçersiz izleme aralığı: %s (1..60000 ms)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'Q':
+            prices_path = optarg;
+            break;
+        case 'W':
+            what_if_report = 1;
+            if (!optarg) break;
+            if (what_if_count == (int)(sizeof(what_if_paths) / sizeof(what_if_paths[0]))) {
+                fprintf(stderr, "En fazla %d --what-if dosyası verilebilir\n", what_if_count);
+                exit(EXIT_FAILURE);
+            }
+            what_if_paths[what_if_count++] = optarg;
+            break;
+        case 'V':
+            travel_days = atof(optarg);
+            if (travel_days < 0.0) {
+                fprintf(stderr, "Geçersiz yol süresi: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'H':
+            halt_at_day = atof(optarg);
+            if (halt_at_day <= 0.0) {
+                fprintf(stderr, "Geçersiz gün: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'U':
+            tune_max_crews = optarg ? atoi(optarg) : 4;
+            if (tune_max_crews <= 0 || tune_max_crews > 8) { // 8^4 = 4096 yerleşim
+                fprintf(stderr, "Geçersiz eniyileme sınırı: %s (1..8)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'B':
+            bench_log_events = optarg ? atol(optarg) : 200000;
+            if (bench_log_events <= 0) {
+                fprintf(stderr, "Geçersiz olay sayısı: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'h':
+            print_usage(argv[0]);
+            exit(EXIT_SUCCESS);
+        default:
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if ((long)total_floors * apartments_per_floor > MAX_UNITS) { // Daire başına bellek sınırlı kalsın
+        fprintf(stderr, "Toplam daire sayısı en fazla %ld olabilir (%d kat x %d daire)\n",
+                MAX_UNITS, total_floors, apartments_per_floor);
+        exit(EXIT_FAILURE);
+    }
+    if (portfolio_sites > 0) {
+        if (portfolio_regions > portfolio_sites) {
+            fprintf(stderr, "Bölge sayısı şantiye sayısını aşamaz (%d > %d)\n", portfolio_regions, portfolio_sites);
+            exit(EXIT_FAILURE);
+        }
+        // Bölgenin işleri tek dizide (int indeks): bölge başına şantiye x düğüm sınırlı kalsın
+        long site_nodes = 3L + 2L * total_floors + (long)total_floors * apartments_per_floor;
+        if ((portfolio_sites + portfolio_regions - 1) / portfolio_regions * site_nodes > INT_MAX / 2) {
+            fprintf(stderr, "Bölge başına şantiye çok fazla: --regions değerini artırın\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// Maliyet matrisinin sütunlarını daire adımlarının kategorilerinden çıkarır ve fiyatların bir
+// dairenin kategori toplamını 32 bitlik hücreye sığdırdığını doğrular (fiyatlar yüklendikten sonra)
+void unit_columns_init(void) {
+    int64_t cell_max[CAT_COUNT] = { 0 };
+    for (int c = 0; c < CAT_COUNT; c++) unit_column[c] = -1;
+    unit_column_count = 0;
+    const struct JobProgram *apt = &job_programs[JOB_APARTMENT];
+    for (int i = 0; i < apt->step_count; i++) {
+        enum CostCategory c = apt->steps[i].category;
+        if (unit_column[c] < 0) {
+            unit_column_category[unit_column_count] = c;
+            unit_column[c] = unit_column_count++;
+        }
+        int64_t material, labor;
+        step_cost(JOB_APARTMENT, i, &material, &labor);
+        cell_max[c] += material + labor;
+        if (cell_max[c] < 0 || cell_max[c] > INT32_MAX) {
+            fprintf(stderr, "Daire başına %s maliyeti maliyet matrisi hücresini aşıyor (en fazla %.2f TL)\n",
+                    category_names[c], INT32_MAX / 100.0);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// Eşlemenin başında SharedData, ardından önbellek satırına hizalı daire dizileri bulunur:
+// ilerleme, maliyet matrisi ve kat başına kaba inşaat maliyeti. Eşlemenin toplam boyutunu
+// döndürür; base NULL değilse dizileri bu eşlemeye yerleştirir.
+size_t shared_layout(void *base, long unit_count) {
+    long stride = (unit_count + UNIT_LANES - 1) / UNIT_LANES * UNIT_LANES;
+    size_t offset = sizeof(struct SharedData);
+    size_t progress_at = offset = (offset + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+    offset += unit_count * sizeof(uint8_t);
+    size_t cost_at = offset = (offset + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+    offset += (size_t)unit_column_count * stride * sizeof(int32_t);
+    size_t shell_at = offset = (offset + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+    offset += total_floors * sizeof(int64_t);
+    if (base) {
+        units.progress = (_Atomic uint8_t *)((char *)base + progress_at);
+        units.cost = (int32_t *)((char *)base + cost_at);
+        units.shell = (int64_t *)((char *)base + shell_at);
+        units.stride = stride;
+        units.count = unit_count;
+    }
+    return offset;
+}
+
+// Daire başına bellek (bayt): paylaşılan dizilerde ilerleme ve kategori başına maliyet hücresi,
+// grafta düğüm, öncül sayacı, ardıl başlangıcı ve iki kenar, yürütücüde sanal iş ya da havuz
+// görevi ile sayacı. Graf kurulurken kenar başına 8 bayt geçici liste de ayrılır (daire başına 16 bayt daha).
+size_t unit_memory_bytes(void) {
+    size_t shared = sizeof(uint8_t) + unit_column_count * sizeof(int32_t);
+    size_t graph = sizeof(struct GraphNode) + 2 * sizeof(int) + 2 * sizeof(int);
+    size_t virtual_job = sizeof(struct SimJob) + sizeof(int);
+    size_t wall_task = sizeof(struct NodeTask) + sizeof(atomic_int) + sizeof(struct TimerEntry); // Askıdaki adım yığında
+    return shared + graph + (virtual_job > wall_task ? virtual_job : wall_task) + sizeof(struct NodeTiming);
+}
+
+// ---------------------------------------------------------------------------
+// Maliyet matrisinin toplamları. Hücreler 32 bit kuruştur, toplamlar 64 bit: her eksende
+// UNIT_LANES hücre bir vektöre yüklenir, 64 bite genişletilip vektör toplayıcıya eklenir.
+// Tamsayı toplama sıradan bağımsız olduğundan sonuç thread sayısından ve koşu düzeninden
+// bağımsız, kuruşu kuruşuna tamdır.
+// ---------------------------------------------------------------------------
+
+typedef int32_t kurus_lanes __attribute__((vector_size(UNIT_LANES * sizeof(int32_t))));
+typedef int64_t kurus_wide __attribute__((vector_size(UNIT_LANES * sizeof(int64_t))));
+
+// n hücrenin toplamı (hizasız başlangıç ve kuyruk da olur)
+static int64_t kurus_sum(const int32_t *cells, long n) {
+    kurus_wide acc = { 0 };
+    long i = 0;
+    for (; i + UNIT_LANES <= n; i += UNIT_LANES) {
+        kurus_lanes v;
+        memcpy(&v, cells + i, sizeof(v));
+        acc += __builtin_convertvector(v, kurus_wide);
+    }
+    int64_t sum = 0;
+    for (int l = 0; l < UNIT_LANES; l++) sum += acc[l];
+    for (; i < n; i++) sum += cells[i];
+    return sum;
+}
+
+// acc[i] += cells[i], i < n: satırları (kat ya da sütun) hücre hücre biriktirir
+static void kurus_accumulate(int64_t *acc, const int32_t *cells, long n) {
+    long i = 0;
+    for (; i + UNIT_LANES <= n; i += UNIT_LANES) {
+        kurus_lanes v;
+        kurus_wide a;
+        memcpy(&v, cells + i, sizeof(v));
+        memcpy(&a, acc + i, sizeof(a));
+        a += __builtin_convertvector(v, kurus_wide);
+        memcpy(acc + i, &a, sizeof(a));
+    }
+    for (; i < n; i++) acc[i] += cells[i];
+}
+
+// Matrisin üç eksendeki toplamları (kuruş)
+struct CostRollup {
+    int64_t category[CAT_COUNT];  // Sütun başına: kategorinin tüm daireleri
+    int64_t *floor;               // Kat başına daire iç maliyetleri (total_floors eleman)
+    int64_t *apartment;           // Kattaki daire numarası başına, tüm katlar (apartments_per_floor eleman)
+    int64_t min_unit, max_unit;   // En ucuz ve en pahalı daire
+    long min_at, max_at;          // Bu dairelerin indeksi
+    int64_t total;                // Tüm daireler
+};
+
+// Matrisi kategori, kat ve daire eksenlerinde toplar; daire toplamları blok blok biriktirilir
+void cost_rollup(struct CostRollup *out) {
+    enum { BLOCK = 1024 };
+    int64_t unit_sum[BLOCK];
+    memset(out->category, 0, sizeof(out->category));
+    memset(out->floor, 0, total_floors * sizeof(int64_t));
+    memset(out->apartment, 0, apartments_per_floor * sizeof(int64_t));
+    out->total = 0;
+    for (int col = 0; col < unit_column_count; col++) { // Kategori toplamı, sütunun kat toplamlarından
+        const int32_t *column = units.cost + col * units.stride;
+        int64_t *category = &out->category[unit_column_category[col]];
+        for (int f = 0; f < total_floors; f++) {
+            const int32_t *row = column + (long)f * apartments_per_floor;
+            int64_t sum = kurus_sum(row, apartments_per_floor);
+            out->floor[f] += sum;
+            *category += sum;
+            kurus_accumulate(out->apartment, row, apartments_per_floor);
+        }
+        out->total += *category;
+    }
+    for (long first = 0; first < units.count; first += BLOCK) { // Daire toplamı: sütunların bloğu üst üste
+        long n = units.count - first < BLOCK ? units.count - first : BLOCK;
+        memset(unit_sum, 0, n * sizeof(int64_t));
+        for (int col = 0; col < unit_column_count; col++) kurus_accumulate(unit_sum, units.cost + col * units.stride + first, n);
+        for (long i = 0; i < n; i++) {
+            if (first + i == 0 || unit_sum[i] < out->min_unit) { out->min_unit = unit_sum[i]; out->min_at = first + i; }
+            if (first + i == 0 || unit_sum[i] > out->max_unit) { out->max_unit = unit_sum[i]; out->max_at = first + i; }
+        }
+    }
+}
+
+// Daire dizilerinden ilerleme ve maliyet özetini yazdıran fonksiyon
+void print_unit_summary(void) {
+    long done = 0;
+    int steps = job_programs[JOB_APARTMENT].step_count;
+    for (long u = 0; u < units.count; u++) {
+        if (atomic_load_explicit(&units.progress[u], memory_order_acquire) == steps) done++;
+    }
+    struct CostRollup rollup;
+    rollup.floor = calloc(total_floors, sizeof(int64_t));
+    rollup.apartment = calloc(apartments_per_floor, sizeof(int64_t));
+    if (!rollup.floor || !rollup.apartment) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    uint64_t start = monotonic_ns(); // Tek geçiş; tekrarlı ölçüm --bench=rollup'tadır
+    cost_rollup(&rollup);
+    double rollup_ms = (monotonic_ns() - start) / 1e6;
+    printf("Tamamlanan daire: %ld / %ld (daire maliyeti en düşük %.2f TL, en yüksek %.2f TL)\n",
+           done, units.count, rollup.min_unit / 100.0, rollup.max_unit / 100.0);
+
+    // Matris defterle kuruşu kuruşuna uyuşmalı: daire kategorilerine yalnızca daire adımları yazar
+    int64_t material[CAT_COUNT], labor[CAT_COUNT], ledger = 0, shell = 0, floor_ledger;
+    cost_totals_kurus(material, labor);
+    for (int col = 0; col < unit_column_count; col++) {
+        enum CostCategory c = unit_column_category[col];
+        ledger += material[c] + labor[c];
+    }
+    for (int f = 0; f < total_floors; f++) shell += units.shell[f];
+    floor_ledger = material[CAT_FLOOR] + labor[CAT_FLOOR];
+    printf(COLOR_CYAN "\n=== KAT VE DAİRE MALİYETLERİ (kuruş matrisi, %d kategori) ===\n" COLOR_RESET, unit_column_count);
+    printf("Daire iç maliyetleri %.2f TL, defter %.2f TL: %s; kaba inşaat %.2f TL, defter %.2f TL: %s\n",
+           rollup.total / 100.0, ledger / 100.0, rollup.total == ledger ? "tam uyuşuyor" : "UYUŞMUYOR",
+           shell / 100.0, floor_ledger / 100.0, shell == floor_ledger ? "tam uyuşuyor" : "UYUŞMUYOR");
+    printf("Toplamlar (kategori, kat, daire numarası, daire): %.3f ms, %.1f M hücre/sn\n", rollup_ms,
+           rollup_ms > 0.0 ? 3.0 * unit_column_count * units.stride / rollup_ms / 1e3 : 0.0);
+
+    int lo = 0, hi = 0; // En ucuz ve en pahalı kat (kaba inşaat dahil)
+    for (int f = 1; f < total_floors; f++) {
+        if (rollup.floor[f] + units.shell[f] < rollup.floor[lo] + units.shell[lo]) lo = f;
+        if (rollup.floor[f] + units.shell[f] > rollup.floor[hi] + units.shell[hi]) hi = f;
+    }
+    printf("Kat     | Kaba inşaat      | Daireler         | Toplam\n");
+    printf("--------|------------------|------------------|-----------------\n");
+    for (int f = 0; f < total_floors; f++) { // Uzun binada yalnızca ilk ve son katlar ile uç değerler
+        if (total_floors > 12 && f >= 3 && f < total_floors - 3 && f != lo && f != hi) {
+            if (f == 3) printf("...     |                  |                  |\n");
+            continue;
+        }
+        printf("%-7d | %16.2f | %16.2f | %16.2f%s\n", f + 1, units.shell[f] / 100.0, rollup.floor[f] / 100.0,
+               (units.shell[f] + rollup.floor[f]) / 100.0, f == hi && hi != lo ? "  en pahalı" : f == lo && hi != lo ? "  en ucuz" : "");
+    }
+    int a_lo = 0, a_hi = 0; // Tüm katlarda aynı numaralı daireler
+    for (int a = 1; a < apartments_per_floor; a++) {
+        if (rollup.apartment[a] < rollup.apartment[a_lo]) a_lo = a;
+        if (rollup.apartment[a] > rollup.apartment[a_hi]) a_hi = a;
+    }
+    printf("Daire numarası başına (tüm katlar): en düşük %d. daire %.2f TL, en yüksek %d. daire %.2f TL\n",
+           a_lo + 1, rollup.apartment[a_lo] / 100.0, a_hi + 1, rollup.apartment[a_hi] / 100.0);
+    printf("En ucuz daire %ld. kat %ld. daire, en pahalı daire %ld. kat %ld. daire\n",
+           rollup.min_at / apartments_per_floor + 1, rollup.min_at % apartments_per_floor + 1,
+           rollup.max_at / apartments_per_floor + 1, rollup.max_at % apartments_per_floor + 1);
+    free(rollup.floor);
+    free(rollup.apartment);
+}
+
+// Matris toplamı: --floors x --apartments boyutundaki matrisin kategori, kat, daire numarası ve
+// daire toplamları; ölçüm toplam en az ~200 M hücre okuyacak kadar tekrarlanır
+static void bench_rollup(void) {
+    struct CostRollup rollup;
+    rollup.floor = calloc(total_floors, sizeof(int64_t));
+    rollup.apartment = calloc(apartments_per_floor, sizeof(int64_t));
+    if (!rollup.floor || !rollup.apartment) {
+        perror("calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int col = 0; col < unit_column_count; col++) { // Sıfır olmayan, düzgün olmayan hücreler
+        for (long u = 0; u < units.count; u++) units.cost[col * units.stride + u] = (int32_t)((u * 2654435761u + col) % 100000);
+    }
+    long cells = 3L * unit_column_count * units.stride;
+    long rounds = 200000000L / cells;
+    if (rounds < 5) rounds = 5;
+    uint64_t start = monotonic_ns();
+    for (long i = 0; i < rounds; i++) cost_rollup(&rollup);
+    bench_report("rollup", "matrix", 1, rounds, monotonic_ns() - start);
+    free(rollup.floor);
+    free(rollup.apartment);
+}
+
+// Simülasyonu seçili modda çalıştırıp sonuç özetini yazdıran fonksiyon
+void run_simulation() {
+    log_init(stdout); // Günlük halkasını ve boşaltıcı thread'i başlat
+
+    // Simülasyon başlangıç mesajı
+    printf(COLOR_GREEN "\n%d KATLI APARTMAN İNŞAAT SIMÜLASYONU BAŞLIYOR\n" COLOR_RESET, total_floors);
+    printf("Toplam süre: %d gün\n", total_days);
+    printf("Bina: %d kat x %d daire = %ld daire (daire başına en fazla %zu bayt, paylaşılan bellek %.1f MB)\n",
+           total_floors, apartments_per_floor, units.count, unit_memory_bytes(), shared_size / 1e6);
+    printf("Çalışma modu: %s\n", run_mode == MODE_VIRTUAL ? "sanal zaman (ayrık olay)" : "gerçek zaman");
+    if (run_mode != MODE_VIRTUAL && floor_procs > 0) printf("Kat süreçleri: %d kalıcı işçi (katlar paylaşılan kuyruktan dağıtılır)\n", floor_procs);
+    else if (run_mode != MODE_VIRTUAL) printf("Kat süreçleri: kat başına fork\n");
+    printf("Tohum: %llu\n", (unsigned long long)run_seed);
+    printf("Zamanlama: %s\n", schedule_names[schedule_mode]);
+    printf("Ekipler (ekip-gün ücreti): elektrik %d x %.2f TL, sıhhi tesisat %d x %.2f TL, boya %d x %.2f TL, asansör %d x %.2f TL\n",
+           crew_counts[RES_ELECTRIC], crew_day_costs[RES_ELECTRIC], crew_counts[RES_PLUMBING], crew_day_costs[RES_PLUMBING],
+           crew_counts[RES_PAINT], crew_day_costs[RES_PAINT], crew_counts[RES_ELEVATOR], crew_day_costs[RES_ELEVATOR]);
+    printf("====================================\n");
+
+    if (trace_path) trace_init(units.count); // İz alanı fork'lardan önce eşlenmeli
+
+    struct timespec wall_start, wall_end; // Gerçek (duvar saati) süre ölçümü
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+
+    struct TaskGraph graph; // İşler ve aralarındaki bağımlılıklar
+    graph_build(&graph, schedule_mode);
+    schedule_log_init(&graph); // Kritik yol için yürütülen programın kaydı
+    metrics_start(); // Canlı ölçümler (construction-top ile izlenir)
+
+    int finish_days;
+    double elapsed_ticks = 0.0; // Kaynak kullanım oranı için çalışma süresi (ölçüm biriminde)
+    if (run_mode == MODE_VIRTUAL) {
+        random_stream(0); // Karşılaştırma koşularıyla ve 0. toplu kopyayla aynı rastgele dizi
+        struct SimResult result;
+        double makespan = run_virtual_simulation(&graph, crew_counts, 1, &result); // Sanal saatle simüle et
+        virtual_events = result.events;
+        elapsed_ticks = makespan * SIM_TICKS_PER_DAY;
+        finish_days = (int)makespan + (makespan > (int)makespan);  // Bitiş zamanını güne yuvarla
+    } else {
+        // Bekleyen adımlar askıya alındığından işçi sayısı daire sayısından bağımsızdır (varsayılan: işlemci sayısı)
+        struct FloorProcs *procs = floor_procs > 0 ? floor_procs_create(floor_procs) : NULL; // Havuz thread'lerinden önce fork et
+        struct WorkerPool *pool = pool_create(pool_workers); // Daireler için kalıcı iş çalma havuzu
+        log_message(MSG_POOL_SIZE, pool->worker_count, 0);
+        run_wallclock_simulation(&graph, pool, procs); // Süreç ve havuzla gerçek zamanlı simüle et
+        pool_destroy(pool);
+        if (procs) floor_procs_destroy(procs);
+        struct timespec done; // Ekip günlükleri: gerçek modda bir saniye bir güne denk gelir
+        clock_gettime(CLOCK_MONOTONIC, &done);
+        add_crew_cost(crew_counts, (done.tv_sec - wall_start.tv_sec) + (done.tv_nsec - wall_start.tv_nsec) / 1e9);
+        finish_days = atomic_load(&construction_day) - 1;
+    }
+    metrics_stop(); // Son durumu yayınla
+    log_shutdown(); // Halkada kalan kayıtları yazdır
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    double wall_ms = (wall_end.tv_sec - wall_start.tv_sec) * 1e3 + (wall_end.tv_nsec - wall_start.tv_nsec) / 1e6;
+    if (run_mode != MODE_VIRTUAL) elapsed_ticks = wall_ms * 1e6;
+
+    struct CriticalPath critical; // Graf serbest bırakılmadan (ölçülen süreye dahil değil)
+    int have_critical = critical_path_compute(&critical);
+    schedule_log_free();
+    graph_free(&graph);
+
+    double total_cost = current_total_cost(); // Dilimleri topla
+
+    // Simülasyon sonu özeti
+    printf(COLOR_GREEN "\n=== İNŞAAT TAMAMLANDI ===\n" COLOR_RESET);
+    printf("Toplam süre: %d gün\n", finish_days); // Toplam gün sayısı
+    printf("Gerçek çalışma süresi: %.2f ms\n", wall_ms); // Duvar saati süresi
+    if (run_mode == MODE_VIRTUAL) printf("Sanal simülasyon: %lu olay işlendi\n", virtual_events);
+    if (resume_path) printf("Kontrol noktasından devam edildi: %s\n", resume_path);
+    if (checkpoints_written > 0) {
+        printf("Kontrol noktaları: %ld yazıldı, %ld atlandı, sonuncusu %.2f. günde; olay döngüsü toplam %.2f ms durdu\n",
+               checkpoints_written, checkpoints_skipped, checkpoint_last_day, checkpoint_stall_ns / 1e6);
+    }
+    if (run_mode != MODE_VIRTUAL && floor_handoff_hist.count > 0) { // Kat süreçlerinden gelen bildirimler ve devir gecikmeleri
+        printf("Kat bildirimleri: %lu (medyan %.1f µs, p99 %.1f µs, en uzun %.1f µs), bildirilen kat maliyeti %.2f TL\n",
+               (unsigned long)floor_handoff_hist.count, hist_percentile(&floor_handoff_hist, 0.5) / 1e3,
+               hist_percentile(&floor_handoff_hist, 0.99) / 1e3, floor_handoff_hist.max / 1e3, floor_reported_cost);
+        if (floor_retries > 0) printf("Çöken süreç yüzünden yeniden inşa edilen kat: %ld\n", floor_retries);
+    }
+    printf("Toplam maliyet: %.2f TL\n", total_cost); // Toplam maliyet
+    printf("Kat başına ortalama maliyet: %.2f TL\n", total_cost/total_floors); // Kat başına maliyet
+    printf("Daire başına ortalama maliyet: %.2f TL\n",
+           total_cost/units.count); // Daire başına maliyet
+    print_unit_summary(); // Daire dizilerinden ilerleme
+    if (trace_arena) trace_write(trace_path); // Zaman çizelgesi (ölçülen süreye dahil değil)
+
+    // Maliyet özetini ve kaynak kullanım raporunu yazdır
+    print_cost_summary();
+    if (what_if_report) print_what_if_report(); // Fiyat değişikliklerinin etkisi (koşu tekrarlanmadan)
+    print_resource_report(elapsed_ticks);
+    if (have_critical) print_critical_path(&critical); // Hangi aşama ya da ekip bitişi belirliyor
+
+    // Boru hattı ile eski sıralı zamanlamanın karşılaştırması
+    print_schedule_comparison(wall_ms);
+    print_delivery_comparison(); // Tek tek ve toplu malzeme taşıma
+}
+
+int main(int argc, char *argv[]) {
+    const char *prog = strrchr(argv[0], '/');
+    if (strcmp(prog ? prog + 1 : argv[0], "construction-top") == 0) top_interval_ms = 100; // İzleyici olarak çağrıldı
+    parse_options(argc, argv); // Çalışma modunu belirle
+    if (top_interval_ms > 0) { // İzleyici yalnızca ölçüm bölgesini okur; simülasyon kaynaklarına dokunmaz
+        run_top(top_interval_ms);
+        return 0;
+    }
+    price_table_init(&prices); // Adım tablolarının fiyatları; fiyat dosyası bunların üzerine yazar
+    if (prices_path) {
+        load_prices(prices_path, &prices);
+        for (int r = 0; r < RES_COUNT; r++) crew_day_costs[r] = prices.crew_day[r]; // Dosyadaki ekip ücretleri kuruşuyla geçerli
+    }
+    load_what_if_files(); // Duyarlılık dosyaları da koşudan önce doğrulanır
+    unit_columns_init(); // Maliyet matrisinin sütunları (shared_layout'tan önce)
+    if (resume_path) checkpoint_open(resume_path); // Yapılandırma ve tohum kontrol noktasından gelir
+    if ((checkpoint_path || halt_at_day > 0.0) && run_mode != MODE_VIRTUAL) { // Gerçek mod tekrarlanabilir değil
+        fprintf(stderr, "--checkpoint ve --halt-at yalnızca sanal modda (-m virtual) kullanılabilir\n");
+        exit(EXIT_FAILURE);
+    }
+    random_init(seed_given ? run_seed : (uint64_t)time(NULL)); // Rastgele sayı üreticisini başlat
+
+    // Paylaşılan bellek oluştur
+    int shm_fd = shm_open("/construction_shm", O_CREAT | O_RDWR, 0666); // Paylaşılan bellek dosyası oluştur
+    if (shm_fd == -1) {
+        perror("shm_open failed"); // Hata kontrolü
+        exit(EXIT_FAILURE);
+    }
+
+    shared_size = shared_layout(NULL, (long)total_floors * apartments_per_floor); // Daire dizileri dahil boyut
+    if (ftruncate(shm_fd, shared_size) == -1) { // Bellek boyutunu ayarla
+        perror("ftruncate failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Paylaşılan belleği eşle
+    shared_data = mmap(NULL, shared_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    if (shared_data == MAP_FAILED) {
+        perror("mmap failed");
+        exit(EXIT_FAILURE);
+    }
+    close(shm_fd); // Eşleme yapıldıktan sonra dosya tanımlayıcısına gerek yok
+
+    // Paylaşılan bellek değişkenlerini sıfırla
+    memset(shared_data, 0, shared_size);
+    shared_layout(shared_data, (long)total_floors * apartments_per_floor); // Daire dizilerini yerleştir
+    cost_ledger_init(); // Maliyet dilimlerini hazırla
+    atomic_store(&shared_data->crash_floor, crash_floor - 1); // Hata enjeksiyonu (-1: kapalı)
+
+    // Taşma dilimini koruyan mutex'i paylaşılan bellekte başlat
+    pthread_mutexattr_t mutex_attr; //Mutex özelliklerini tanımlamak için bir mutex öznitelik nesnesi oluştur
+    pthread_mutexattr_init(&mutex_attr);
+    pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED); // Mutex'in süreçler arasında paylaşılması sağlanır
+                                                                       //PTHREAD_PROCESS_SHARED ayarı, mutex'in yalnızca aynı süreç içindeki iş parçacıkları
+                                                                       //tarafından değil, farklı süreçler tarafından da kullanılabileceğini belirtir.
+    pthread_mutex_init(&shared_data->cost_mutex, &mutex_attr);         //Paylaşılan bellekteki mutex'i başlat:
+    pthread_mutexattr_destroy(&mutex_attr);                            // Mutex öznitelik nesnesini yok et:
+
+    // Kaynak semaforlarını ekip sayılarıyla başlat
+    for (int r = 0; r < RES_COUNT; r++) sem_init(&resource_sem[r], 0, crew_counts[r]);
+
+    if (event_log_path && !analyze_path) event_log_open(event_log_path); // Kat süreçleri fork edilmeden önce
+
+    if (analyze_path) run_analyze(analyze_path);                        // Olay günlüğü çözümlemesi
+    else if (bench_suites) run_bench(bench_suites);                     // Kıyaslama takımı (JSON satırları)
+    else if (bench_log_events > 0) run_log_benchmark(bench_log_events); // Yalnızca günlük kıyaslaması istendi
+    else if (tune_max_crews > 0) run_tune(tune_max_crews);              // Ekip eniyilemesi
+    else if (batch_replicas > 0) run_batch(batch_replicas);             // Monte Carlo toplu koşu
+    else if (portfolio_sites > 0) run_portfolio(portfolio_sites);       // Çok şantiyeli portföy
+    else run_simulation();                                              // Binayı simüle et ve özetle
+
+    if (event_log) event_log_close();
+
+    // Kaynakları temizle
+    pthread_mutex_destroy(&shared_data->cost_mutex); // Mutex'i yok et
+    munmap(shared_data, shared_size); // Paylaşılan belleği serbest bırak
+    shm_unlink("/construction_shm"); // Paylaşılan bellek dosyasını kaldır
+
+    for (int r = 0; r < RES_COUNT; r++) sem_destroy(&resource_sem[r]); // Kaynak semaforlarını yok et
 
     return 0; // Programı başarıyla sonlandır
 }